@@ -0,0 +1,158 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <climits>
+#include "src/main.hxx"
+
+using namespace std;
+
+
+
+
+// You can define datatype with -DTYPE=...
+#ifndef TYPE
+#define TYPE float
+#endif
+
+
+
+
+// Benchmark sweep over graphs, thread counts, tolerances, and variants.
+// Usage: bench [-t 1,2,4] [-e 1e-6,1e-10] [-r repeat] [-p profile.csv|.json] [graph.mtx ...]
+// Without graphs, synthetic uniform and R-MAT graphs (fixed seed) are used.
+// A summary CSV is written to stdout; per-sweep records of barrier-free
+// variants are written to the profile file, if given. By default, thread
+// counts step through powers of 2 and whole NUMA nodes, so that NUMA
+// variants (pinned, node-local ranges) report per-socket scaling. Their
+// times include page placement, which is done once per thread count.
+
+struct BenchOptions {
+  vector<int>    threads;
+  vector<double> tolerances;
+  vector<string> graphs;
+  string profile;
+  int repeat;
+
+  BenchOptions() : repeat(1) {}
+};
+
+
+template <class T, class FP>
+auto splitList(const char *s, FP fp) {
+  vector<T> a;
+  stringstream ss(s); string x;
+  while (getline(ss, x, ',')) a.push_back(fp(x));
+  return a;
+}
+
+
+inline BenchOptions parseBenchOptions(int argc, char **argv) {
+  BenchOptions o;
+  for (int i=1; i<argc; ++i) {
+    if      (!strcmp(argv[i], "-t") && i+1<argc) o.threads    = splitList<int>(argv[++i], [](auto& x) { return stoi(x); });
+    else if (!strcmp(argv[i], "-e") && i+1<argc) o.tolerances = splitList<double>(argv[++i], [](auto& x) { return stod(x); });
+    else if (!strcmp(argv[i], "-r") && i+1<argc) o.repeat     = stoi(argv[++i]);
+    else if (!strcmp(argv[i], "-p") && i+1<argc) o.profile    = argv[++i];
+    else o.graphs.push_back(argv[i]);
+  }
+  if (o.threads.empty()) {
+    auto tp = numaTopology();
+    int  TS = omp_get_max_threads();
+    for (int t=1; t<TS; t*=2)
+      o.threads.push_back(t);
+    for (int t=1; t<TS; ++t)
+      if (pinThreadNode(tp, t)!=pinThreadNode(tp, t-1)) o.threads.push_back(t);
+    o.threads.push_back(TS);
+    sort(o.threads.begin(), o.threads.end());
+    o.threads.erase(unique(o.threads.begin(), o.threads.end()), o.threads.end());
+  }
+  if (o.tolerances.empty()) o.tolerances = {1e-6, 1e-10};
+  if (o.graphs.empty())     o.graphs = {"@uniform", "@rmat"};
+  return o;
+}
+
+
+// Load graph from file, or generate a synthetic one (@uniform, @rmat).
+inline auto loadBenchGraph(const string& name) {
+  OutDiGraph<int> x;
+  mt19937 rnd(42);
+  if      (name=="@uniform") randomGraphW(x, rnd, 1 << 17, 16 << 17);
+  else if (name=="@rmat")    rmatGraphW(x, rnd, 17, 16 << 17);
+  else readMtxW(x, name.c_str());
+  selfLoopU(x, None(), [](auto u) { return true; });
+  return x;
+}
+
+
+
+
+// CSR in-edge offsets are of type I (int, or size_t for over 2^31 edges).
+template <class I, class H>
+void runBench(const string& name, const H& xt, const BenchOptions& b, ostream *pf, bool json, bool& first) {
+  using T = TYPE;
+  enum NormFunction { L0=0, L1=1, L2=2, Li=3 };
+  vector<T> *init = nullptr;
+  float damping   = 0.85;
+  const char *variants[] = {"OmpUnordered", "OmpOrdered", "Barrierfree", "BarrierfreeEdgePartition", "BarrierfreeEdgePartitionSteal", "BarrierfreeEdgePartitionGlobal", "BarrierfreeEdgePartitionNuma", "BarrierfreeEdgePartitionStealNuma"};
+  auto tp = numaTopology();
+  PagerankCsr<T, I> x;
+  pagerankCsrOmpW(x, xt, xt.vertexKeys());
+  // Reference ranks, with a single thread and tight tolerance.
+  omp_set_num_threads(1);
+  auto a0 = pagerankMonolithicSeq<false, false>(x, init, {1, Li, damping, 1e-14f});
+  for (int t : b.threads) {
+    int nodes = pinThreadNode(tp, t-1) + 1;
+    omp_set_num_threads(t);
+    for (double E : b.tolerances) {
+      for (int v=0; v<8; ++v) {
+        PagerankOptions<T> o(b.repeat, Li, damping, T(E), 500, v>=3? 1 : 0, v==4 || v==7, v==5);
+        o.profile = pf && v>=2;
+        o.numa    = v>=6;
+        auto a = v==0? pagerankMonolithicOmp<false, false>(x, init, o) :
+                 v==1? pagerankMonolithicOmp<true,  false>(x, init, o) :
+                       pagerankBarrierfreeOmp<true, false>(x, init, o);
+        auto e = l1Norm(a.ranks, a0.ranks);
+        printf("%s,%zu,%zu,%d,%d,%.0e,%s,%.3f,%d,%.4e\n", name.c_str(), size_t(xt.order()), size_t(xt.size()), t, nodes, E, variants[v], a.time, a.iterations, e);
+        if (!o.profile) continue;
+        char p[1024];
+        snprintf(p, sizeof(p), "%s,%d,%.0e,%s,", name.c_str(), t, E, variants[v]);
+        if (json) {
+          *pf << (first? "[" : ",\n") << "{\"graph\":\"" << name << "\",\"threads\":" << t << ",\"tolerance\":" << E;
+          *pf << ",\"variant\":\"" << variants[v] << "\",\"sweeps\":";
+          writePagerankSweepsJson(*pf, a.sweeps);
+          *pf << '}';
+        }
+        else {
+          if (first) writePagerankSweepsCsvHeader(*pf, "graph,threads,tolerance,variant,");
+          writePagerankSweepsCsv(*pf, a.sweeps, p);
+        }
+        first = false;
+      }
+    }
+  }
+}
+
+
+int main(int argc, char **argv) {
+  auto b = parseBenchOptions(argc, argv);
+  ofstream pf;
+  bool json  = b.profile.size()>=5 && b.profile.substr(b.profile.size()-5)==".json";
+  bool first = true;
+  if (!b.profile.empty()) pf.open(b.profile);
+  printf("graph,order,size,threads,nodes,tolerance,variant,time,iterations,error\n");
+  for (const auto& name : b.graphs) {
+    auto x  = loadBenchGraph(name);
+    auto xt = transposeWithDegree(x);
+    if (xt.size()>size_t(INT_MAX)) runBench<size_t>(name, xt, b, pf.is_open()? &pf : nullptr, json, first);
+    else runBench<int>(name, xt, b, pf.is_open()? &pf : nullptr, json, first);
+    fflush(stdout);
+  }
+  if (json && pf.is_open()) pf << (first? "[]\n" : "]\n");
+  return 0;
+}
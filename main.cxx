@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <random>
+#include <climits>
 #include "src/main.hxx"
 
 using namespace std;
@@ -23,8 +25,18 @@ using namespace std;
 
 
 
-template <class G, class H>
-void runPagerank(const G& x, const H& xt, int repeat) {
+template <class T>
+void printThreads(const PagerankResult<T>& a) {
+  for (size_t t=0; t<a.threads.size(); t++) {
+    const auto& s = a.threads[t];
+    printf("- thread %02zu: [%09d, %09d) %03d iters. %03d steals [%09.3f ms busy; %09.3f ms idle]\n", t, s.begin, s.end, s.iterations, s.steals, s.time, s.idle);
+  }
+}
+
+
+// CSR in-edge offsets are of type I (int, or size_t for over 2^31 edges).
+template <class I, class G, class H>
+void runPagerank(const G& x, const H& xt, int repeat, const char *file, const char *cache) {
   using T = TYPE;
   enum NormFunction { L0=0, L1=1, L2=2, Li=3 };
   vector<T> *init = nullptr;
@@ -50,12 +62,151 @@ void runPagerank(const G& x, const H& xt, int repeat) {
   auto a4 = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance});
   auto e4 = l1Norm(a4.ranks, a1.ranks);
   printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrdered\n", a4.time, a4.iterations, e4);
+  printThreads(a4);
+
+  // Find pagerank with barrier-free iterations, partitioned by in-edges (ordered, no dead ends).
+  auto a5 = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 1});
+  auto e5 = l1Norm(a5.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartition\n", a5.time, a5.iterations, e5);
+  printThreads(a5);
+
+  // Find pagerank with barrier-free iterations, partitioned by in-edges, with work stealing (ordered, no dead ends).
+  auto a6 = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 1, true});
+  auto e6 = l1Norm(a6.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionSteal\n", a6.time, a6.iterations, e6);
+  printThreads(a6);
+
+  // Find pagerank with barrier-free iterations, partitioned by in-edges, with global convergence (ordered, no dead ends).
+  auto a7 = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 1, false, true});
+  auto e7 = l1Norm(a7.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionGlobal\n", a7.time, a7.iterations, e7);
+  printThreads(a7);
+
+  // Find pagerank with barrier-free iterations, partitioned by in-edges, with threads pinned and ranges on their NUMA node (ordered, no dead ends).
+  auto a7n = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 1, false, false, 0, 0, 0, false, true});
+  auto e7n = l1Norm(a7n.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionNuma\n", a7n.time, a7n.iterations, e7n);
+  printThreads(a7n);
+
+  // Find pagerank accelerated with OpenMP, with vertices reordered (ordered, no dead ends).
+  const char *reorders[] = {"", "Components", "Rcm", "InDegree"};
+  for (int ro=1; ro<=3; ro++) {
+    auto a = pagerankMonolithicOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 0, false, false, ro});
+    auto e = l1Norm(a.ranks, a1.ranks);
+    printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrdered%s\n", a.time, a.iterations, e, reorders[ro]);
+  }
+
+  // Find pagerank with barrier-free iterations, with vertices reordered, partitioned by in-edges along components (ordered, no dead ends).
+  for (int ro=1; ro<=3; ro++) {
+    auto a = pagerankBarrierfreeOmp<true, false>(x, xt, init, {repeat, Li, damping, tolerance, 500, 1, false, true, ro});
+    auto e = l1Norm(a.ranks, a1.ranks);
+    printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionGlobal%s\n", a.time, a.iterations, e, reorders[ro]);
+  }
+
+  // Build CSR once, and reuse it for multiple pagerank computations.
+  PagerankCsr<T, I> xc;
+  float tc = measureDuration([&]() { pagerankCsrOmpW(xc, xt, xt.vertexKeys()); }, repeat);
+  printf("[%09.3f ms] pagerankCsrOmp\n", tc);
+
+  // Find pagerank accelerated with OpenMP on prebuilt CSR (ordered, no dead ends).
+  auto a8 = pagerankMonolithicOmp<true, false>(xc, init, {repeat, Li, damping, tolerance});
+  auto e8 = l1Norm(a8.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrderedCsr\n", a8.time, a8.iterations, e8);
+
+  // Find pagerank with barrier-free iterations on prebuilt CSR, partitioned by in-edges, with global convergence (ordered, no dead ends).
+  auto a9 = pagerankBarrierfreeOmp<true, false>(xc, init, {repeat, Li, damping, tolerance, 500, 1, false, true});
+  auto e9 = l1Norm(a9.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionGlobalCsr\n", a9.time, a9.iterations, e9);
+
+  // Find pagerank on prebuilt CSR with 64-bit in-edge offsets (ordered, no dead ends).
+  PagerankCsr<T, size_t> xw;
+  pagerankCsrOmpW(xw, xt, xt.vertexKeys());
+  auto aw = pagerankMonolithicOmp<true, false>(xw, init, {repeat, Li, damping, tolerance});
+  auto ew = l1Norm(aw.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrderedCsrWide\n", aw.time, aw.iterations, ew);
+
+  // Find pagerank on prebuilt CSR, with compact in-edges and/or contributions (ordered, no dead ends).
+  const char *compresses[] = {"", "Varint"};
+  const char *precisions[] = {"", "Float", "Bf16"};
+  for (int cm=0; cm<=1; cm++) {
+    for (int pr=0; pr<=2; pr++) {
+      if (cm==0 && pr==0) continue;
+      auto a = pagerankMonolithicOmp<true, false>(xc, init, {repeat, Li, damping, tolerance, 500, 0, false, false, 0, cm, pr});
+      auto e = l1Norm(a.ranks, a1.ranks);
+      printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrderedCsr%s%s\n", a.time, a.iterations, e, compresses[cm], precisions[pr]);
+      auto b = pagerankBarrierfreeOmp<true, false>(xc, init, {repeat, Li, damping, tolerance, 500, 1, false, true, 0, cm, pr});
+      auto f = l1Norm(b.ranks, a1.ranks);
+      printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankBarrierfreeOmpOrderedEdgePartitionGlobalCsr%s%s\n", b.time, b.iterations, f, compresses[cm], precisions[pr]);
+    }
+  }
+  printf("[%zu bytes efrom; %zu bytes coded] pagerankPackOmp\n", xc.size() * sizeof(int), xc.packed.ebytes.size());
+
+  // Load CSR directly from MTX file, in parallel (compare with loading graph, adding self-loops, and transposing).
+  PagerankCsr<T, I> xm;
+  float tg = measureDuration([&]() { auto y = readMtxOutDiGraph(file); selfLoopU(y, None(), [](auto u) { return true; }); auto yt = transposeWithDegree(y); }, 1);
+  float tm = measureDuration([&]() { readMtxPagerankCsrOmpW(xm, file); }, repeat);
+  printf("[%09.3f ms] readMtxOutDiGraph+selfLoop+transposeWithDegree\n", tg);
+  printf("[%09.3f ms] readMtxPagerankCsrOmp\n", tm);
+  auto a10 = pagerankMonolithicOmp<true, false>(xm, init, {repeat, Li, damping, tolerance});
+  auto e10 = l1Norm(a10.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrderedMtxCsr\n", a10.time, a10.iterations, e10);
+  if (!cache) return;
+
+  // Write CSR to a binary cache, and load it back.
+  PagerankCsr<T, I> xb;
+  float tw = measureDuration([&]() { writePagerankCsr(cache, xm); }, 1);
+  float tb = measureDuration([&]() { readPagerankCsrOmpW(xb, cache); }, repeat);
+  printf("[%09.3f ms] writePagerankCsr\n", tw);
+  printf("[%09.3f ms] readPagerankCsrOmp\n", tb);
+  auto a11 = pagerankMonolithicOmp<true, false>(xb, init, {repeat, Li, damping, tolerance});
+  auto e11 = l1Norm(a11.ranks, a1.ranks);
+  printf("[%09.3f ms; %03d iters.] [%.4e err.] pagerankOmpOrderedCachedCsr\n", a11.time, a11.iterations, e11);
+}
+
+
+template <class I, class G, class H>
+void runPagerankBatch(const G& x, const H& xt, int repeat) {
+  using T = TYPE;
+  enum NormFunction { L0=0, L1=1, L2=2, Li=3 };
+  vector<T> *init = nullptr;
+  float damping   = 0.85;
+  float tolerance = 1e-10;
+  PagerankOptions<T> o = {1, Li, damping, tolerance, 500, 1, false, true};
+  mt19937 rnd(42);
+
+  // Find initial ranks on a CSR that is then updated in place, batch by batch.
+  auto y  = x;
+  auto yt = xt;
+  PagerankCsr<T, I> yc;
+  pagerankCsrOmpW(yc, yt, yt.vertexKeys());
+  pagerankBarrierfreeOmp<true, false>(yc, init, o);
+
+  // Apply batches of random edge deletions and insertions (half each).
+  for (size_t batch : {2, 20, 200, 2000}) {
+    float tb = 0, tf = 0; double eb = 0, ef = 0; size_t m = 0;
+    int   lb = 0, lf = 0;
+    for (int i=0; i<repeat; i++) {
+      auto del = randomEdgeDeletions(y, rnd, batch/2);
+      auto ins = randomEdgeInsertions(y, rnd, batch/2);
+      auto ab  = pagerankBarrierfreeOmpBatchU<true, false>(yc, y, yt, del, ins, o);
+      // Full recompute is timed with its CSR build, as batch update includes CSR update.
+      vector<T> rf; int li = 0;
+      float ti = measureDuration([&]() { auto af = pagerankBarrierfreeOmp<true, false>(y, yt, init, o); rf = move(af.ranks); li = af.iterations; }, 1);
+      auto ar  = pagerankMonolithicOmp<true, false>(y, yt, init, {1, Li, damping, tolerance});
+      tb += ab.time; lb += ab.iterations; eb += l1Norm(ab.ranks, ar.ranks);
+      tf += ti;      lf += li;            ef += l1Norm(rf, ar.ranks);
+      m  += del.size() + ins.size();
+    }
+    printf("[%09.3f ms; %03d iters.] [%.4e err.] [%.3e updates/s] pagerankBarrierfreeOmpBatch {batch=%zu}\n", tb/repeat, lb/repeat, eb/repeat, m/(tb/1000), batch);
+    printf("[%09.3f ms; %03d iters.] [%.4e err.] [%.3e updates/s] pagerankBarrierfreeOmpFull {batch=%zu}\n", tf/repeat, lf/repeat, ef/repeat, m/(tf/1000), batch);
+  }
 }
 
 
 int main(int argc, char **argv) {
   char *file = argv[1];
   int repeat = argc>2? stoi(argv[2]) : 5;
+  char *cache = argc>3? argv[3] : nullptr;
   printf("Loading graph %s ...\n", file);
   auto x  = readMtxOutDiGraph(file); println(x);
   auto fl = [](auto u) { return true; };
@@ -63,7 +214,16 @@ int main(int argc, char **argv) {
   auto xt = transposeWithDegree(x);  print(xt); printf(" (transposeWithDegree)\n");
   omp_set_num_threads(MAX_THREADS);
   printf("OMP_NUM_THREADS=%d\n", MAX_THREADS);
-  runPagerank(x, xt, repeat);
+  printf("SIMD_LEVEL=%d\n", simdLevel());
+  printf("CSR_OFFSET_BITS=%d\n", xt.size()>size_t(INT_MAX)? 64 : 32);
+  if (xt.size()>size_t(INT_MAX)) {
+    runPagerank<size_t>(x, xt, repeat, file, cache);
+    runPagerankBatch<size_t>(x, xt, repeat);
+  }
+  else {
+    runPagerank<int>(x, xt, repeat, file, cache);
+    runPagerankBatch<int>(x, xt, repeat);
+  }
   printf("\n");
   return 0;
 }
@@ -372,6 +372,15 @@ using std::cout;
       M += degree(u); \
     }); \
     return a; \
+  } \
+  inline bool correctVertex(const K& u, bool unq=false) { \
+    if (!hasVertex(u)) return false; \
+    bool a = false; M -= degree(u); \
+    vector<pair<K, E>> buf; \
+    a |= e0; \
+    a |= e1; \
+    M += degree(u); \
+    return a; \
   }
 #endif
 
@@ -505,7 +514,8 @@ using std::cout;
 
 #ifndef GRAPH_CORRECT_FROM
 #define GRAPH_CORRECT_FROM(K, V, E, x) \
-  inline bool correct(bool unq=false) noexcept { return x.correct(unq); }
+  inline bool correct(bool unq=false) noexcept { return x.correct(unq); } \
+  inline bool correctVertex(const K& u, bool unq=false) noexcept { return x.correctVertex(u, unq); }
 #define GRAPH_CLEAR_FROM(K, V, E, x) \
   inline bool clear() noexcept { return x.clear(); }
 #define GRAPH_RESIZE_FROM(K, V, E, x) \
@@ -2,6 +2,8 @@
 #include <istream>
 #include <ostream>
 #include <utility>
+#include <cstdint>
+#include <cstring>
 
 using std::pair;
 using std::istream;
@@ -52,3 +54,32 @@ struct None {
 #define tclass2s template <class, class, class...> class
 #define tclass3s template <class, class, class, class...> class
 #endif
+
+
+
+
+// BFLOAT16
+// --------
+// Upper half of an IEEE float (8-bit exponent, 7-bit mantissa).
+// Conversion from float rounds to nearest even.
+
+#ifndef BFLOAT16
+struct BFloat16 {
+  uint16_t x;
+
+  // Conversion operators.
+  operator float() const noexcept {
+    uint32_t b = uint32_t(x) << 16; float a;
+    memcpy(&a, &b, sizeof(a));
+    return a;
+  }
+
+  // Lifetime operators.
+  BFloat16() : x(0) {}
+  BFloat16(float v) {
+    uint32_t b; memcpy(&b, &v, sizeof(b));
+    x = uint16_t((b + 0x7FFF + ((b >> 16) & 1)) >> 16);
+  }
+};
+#define BFLOAT16 BFloat16
+#endif
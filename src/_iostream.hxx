@@ -8,6 +8,10 @@
 #include <iostream>
 #include <type_traits>
 #include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using std::pair;
 using std::array;
@@ -38,6 +42,40 @@ string readFile(const char *pth) {
 
 
 
+// MAPPED-FILE
+// -----------
+// Read-only memory mapping of a whole file (empty if it cannot be opened).
+
+class MappedFile {
+  const char *ptr = nullptr;
+  size_t      len = 0;
+
+  public:
+  MappedFile(const char *pth) {
+    int fd = open(pth, O_RDONLY);
+    if (fd<0) return;
+    struct stat st;
+    if (fstat(fd, &st)==0 && st.st_size>0) {
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p!=MAP_FAILED) { ptr = (const char*) p; len = st.st_size; }
+    }
+    close(fd);
+    if (ptr) madvise((void*) ptr, len, MADV_SEQUENTIAL);
+  }
+  ~MappedFile() {
+    if (ptr) munmap((void*) ptr, len);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  inline const char* data() const noexcept { return ptr; }
+  inline size_t size()      const noexcept { return len; }
+  inline bool empty()       const noexcept { return len==0; }
+};
+
+
+
+
 // WRITE
 // -----
 
@@ -5,6 +5,8 @@
 #include "_iostream.hxx"
 #include "_iterator.hxx"
 #include "_openmp.hxx"
+#include "_numa.hxx"
+#include "_simd.hxx"
 #include "_string.hxx"
 #include "_utility.hxx"
 #include "_vector.hxx"
@@ -0,0 +1,161 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <omp.h>
+
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::min;
+using std::max;
+
+
+
+
+// READ-CPU-LIST
+// -------------
+// Parse a kernel cpu/node list, such as "0-3,8-11".
+
+inline vector<int> readCpuList(const string& pth) {
+  vector<int> a; string s;
+  ifstream f(pth);
+  if (!getline(f, s)) return a;
+  const char *p = s.c_str();
+  while (*p) {
+    char *q; int i = strtol(p, &q, 10), j = i;
+    if (q==p) break;
+    if (*q=='-') j = strtol(q+1, &q, 10);
+    for (int k=i; k<=j; ++k) a.push_back(k);
+    p = *q==','? q+1 : q;
+  }
+  return a;
+}
+
+
+
+
+// NUMA-TOPOLOGY
+// -------------
+// CPUs available to this process, grouped by NUMA node (from sysfs).
+// Falls back to a single node on systems without NUMA information.
+
+struct NumaTopology {
+  vector<int> cpus;   // available cpus, grouped by node
+  vector<int> nodes;  // node of each cpu
+  int count;          // no. of nodes with available cpus
+
+  NumaTopology() : count(0) {}
+};
+
+
+inline NumaTopology numaTopology() {
+  NumaTopology a;
+  cpu_set_t s; CPU_ZERO(&s);
+  sched_getaffinity(0, sizeof(s), &s);
+  auto ns = readCpuList("/sys/devices/system/node/online");
+  for (int n : ns) {
+    size_t i = a.cpus.size();
+    for (int c : readCpuList("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist")) {
+      if (c>=CPU_SETSIZE || !CPU_ISSET(c, &s)) continue;
+      a.cpus.push_back(c);
+      a.nodes.push_back(a.count);
+    }
+    if (a.cpus.size()>i) ++a.count;
+  }
+  if (a.count>0) return a;
+  for (int c=0; c<CPU_SETSIZE; ++c) {
+    if (!CPU_ISSET(c, &s)) continue;
+    a.cpus.push_back(c);
+    a.nodes.push_back(0);
+  }
+  a.count = 1;
+  return a;
+}
+
+
+
+
+// PIN-THREADS
+// -----------
+// Pin thread (t) to cpu (t) of topology, filling one node before the next.
+// Hence the threads of a node have consecutive ids.
+
+inline int pinThreadNode(const NumaTopology& x, int t) {
+  return x.nodes[t % x.cpus.size()];
+}
+
+inline bool pinThread(const NumaTopology& x, int t) {
+  cpu_set_t s; CPU_ZERO(&s);
+  CPU_SET(x.cpus[t % x.cpus.size()], &s);
+  return sched_setaffinity(0, sizeof(s), &s)==0;
+}
+
+inline bool unpinThread(const NumaTopology& x) {
+  cpu_set_t s; CPU_ZERO(&s);
+  for (int c : x.cpus) CPU_SET(c, &s);
+  return sched_setaffinity(0, sizeof(s), &s)==0;
+}
+
+
+// Pin all OpenMP threads, and get the node of each thread.
+inline vector<int> pinThreadsOmp(const NumaTopology& x) {
+  int TS = omp_get_max_threads();
+  vector<int> a(TS);
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; ++t) {
+    pinThread(x, t);
+    a[t] = pinThreadNode(x, t);
+  }
+  return a;
+}
+
+// Let all OpenMP threads run on any available cpu again.
+inline void unpinThreadsOmp(const NumaTopology& x) {
+  int TS = omp_get_max_threads();
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; ++t)
+    unpinThread(x);
+}
+
+
+
+
+// FIRST-TOUCH
+// -----------
+// Move whole pages of range [i, i+n) to the node of the calling thread.
+// The pages are dropped and rewritten, so that the kernel allocates them
+// afresh on the writer's node (first-touch). This is done in chunks, so
+// only a small buffer is needed. Partial pages at either end are left
+// alone, as they may be shared with neighbouring ranges.
+
+#define FIRST_TOUCH_CHUNK (256 * 1024)
+
+template <class T>
+void firstTouchU(T *x, size_t n) {
+  static const uintptr_t P = sysconf(_SC_PAGESIZE);
+  const uintptr_t B = max(P, uintptr_t(FIRST_TOUCH_CHUNK) & ~(P-1));
+  uintptr_t b = (uintptr_t(x) + P-1) & ~(P-1);
+  uintptr_t e = uintptr_t(x + n) & ~(P-1);
+  if (e<=b) return;
+  vector<char> buf(min(B, e - b));
+  for (uintptr_t i=b; i<e; i+=B) {
+    size_t m = min(B, e - i);
+    memcpy(buf.data(), (void*) i, m);
+    if (madvise((void*) i, m, MADV_DONTNEED)!=0) return;
+    memcpy((void*) i, buf.data(), m);
+  }
+}
+
+template <class T>
+inline void firstTouchU(vector<T>& x, size_t i, size_t n) {
+  if (i>=x.size()) return;
+  firstTouchU(x.data()+i, min(n, x.size()-i));
+}
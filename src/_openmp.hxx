@@ -30,6 +30,60 @@ using std::sqrt;
 
 
 
+// GATHER-VALUES
+// -------------
+
+template <class T, class K, class TA>
+void gatherValuesOmp(const T *x, const K *is, TA *a, size_t N) {
+  if (N<SIZE_MIN_OMPM) { for (size_t j=0; j<N; ++j) a[j] = x[is[j]]; return; }
+  #pragma omp parallel for schedule(auto)
+  for (size_t j=0; j<N; ++j)
+    a[j] = x[is[j]];
+}
+template <class T, class K, class TA>
+inline void gatherValuesOmp(const vector<T>& x, const vector<K>& is, vector<TA>& a) {
+  gatherValuesOmp(x.data(), is.data(), a.data(), is.size());
+}
+
+template <class T, class K, class TA>
+inline void gatherValuesOmpW(TA *a, const T *x, const K *is, size_t N) {
+  gatherValuesOmp(x, is, a, N);
+}
+template <class T, class K, class TA>
+inline void gatherValuesOmpW(vector<TA>& a, const vector<T>& x, const vector<K>& is) {
+  gatherValuesOmp(x, is, a);
+}
+
+
+
+
+// SCATTER-VALUES
+// --------------
+
+template <class T, class K, class TA>
+void scatterValuesOmp(const T *x, const K *is, TA *a, size_t N) {
+  if (N<SIZE_MIN_OMPM) { for (size_t j=0; j<N; ++j) a[is[j]] = x[j]; return; }
+  #pragma omp parallel for schedule(auto)
+  for (size_t j=0; j<N; ++j)
+    a[is[j]] = x[j];
+}
+template <class T, class K, class TA>
+inline void scatterValuesOmp(const vector<T>& x, const vector<K>& is, vector<TA>& a) {
+  scatterValuesOmp(x.data(), is.data(), a.data(), is.size());
+}
+
+template <class T, class K, class TA>
+inline void scatterValuesOmpW(TA *a, const T *x, const K *is, size_t N) {
+  scatterValuesOmp(x, is, a, N);
+}
+template <class T, class K, class TA>
+inline void scatterValuesOmpW(vector<TA>& a, const vector<T>& x, const vector<K>& is) {
+  scatterValuesOmp(x, is, a);
+}
+
+
+
+
 // COPY-VALUES
 // -----------
 
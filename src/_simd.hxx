@@ -0,0 +1,842 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include <omp.h>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#define SIMD_TARGET(x) __attribute__((target(x)))
+#endif
+#include "_vector.hxx"
+#include "_openmp.hxx"
+
+using std::vector;
+using std::abs;
+using std::max;
+using std::min;
+using std::sqrt;
+
+
+
+
+// SIMD OPERATIONS
+// ---------------
+// Kernels are compiled for AVX2 and AVX-512 (in addition to scalar), and one
+// is chosen at runtime. Results can differ from scalar in the last bits, as
+// values are summed in a different order.
+
+#define SIZE_MIN_SIMD 16
+#define SIZE_BLOCK_SIMD_OMP 4096  // elements reduced by a thread at a time
+
+
+
+
+// SIMD-LEVEL
+// ----------
+// 0=scalar, 1=AVX2, 2=AVX-512.
+
+inline int simdLevelDetect() {
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return 2;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return 1;
+#endif
+  return 0;
+}
+
+inline int& simdLevelRef() {
+  static int a = simdLevelDetect();
+  return a;
+}
+inline int simdLevel() {
+  return simdLevelRef();
+}
+// Limit instruction set used (cannot exceed what the CPU supports).
+inline void simdLevelSet(int l) {
+  simdLevelRef() = max(0, min(l, simdLevelDetect()));
+}
+
+
+
+
+#ifdef SIMD_X86
+// HORIZONTAL-REDUCE
+// -----------------
+
+SIMD_TARGET("avx2")
+inline float sumAvx2(__m256 x) {
+  alignas(32) float t[8]; _mm256_store_ps(t, x);
+  return ((t[0]+t[1]) + (t[2]+t[3])) + ((t[4]+t[5]) + (t[6]+t[7]));
+}
+SIMD_TARGET("avx2")
+inline double sumAvx2(__m256d x) {
+  alignas(32) double t[4]; _mm256_store_pd(t, x);
+  return (t[0]+t[1]) + (t[2]+t[3]);
+}
+SIMD_TARGET("avx2")
+inline float maxAvx2(__m256 x) {
+  alignas(32) float t[8]; _mm256_store_ps(t, x);
+  return max(max(max(t[0], t[1]), max(t[2], t[3])), max(max(t[4], t[5]), max(t[6], t[7])));
+}
+SIMD_TARGET("avx2")
+inline double maxAvx2(__m256d x) {
+  alignas(32) double t[4]; _mm256_store_pd(t, x);
+  return max(max(t[0], t[1]), max(t[2], t[3]));
+}
+
+
+// Through a store, as GCC warns on the undefined lanes of _mm512_reduce_*_ps.
+// Lanes are combined in the same order (halving), so results are unchanged.
+SIMD_TARGET("avx512f")
+inline float sumAvx512(__m512 x) {
+  alignas(64) float t[16]; _mm512_store_ps(t, x);
+  for (int i=0; i<8; ++i) t[i] = t[i+8] + t[i];
+  for (int i=0; i<4; ++i) t[i] = t[i+4] + t[i];
+  return (t[0] + t[2]) + (t[1] + t[3]);
+}
+SIMD_TARGET("avx512f")
+inline float maxAvx512(__m512 x) {
+  alignas(64) float t[16]; _mm512_store_ps(t, x);
+  for (int i=0; i<8; ++i) t[i] = max(t[i+8], t[i]);
+  for (int i=0; i<4; ++i) t[i] = max(t[i+4], t[i]);
+  return max(max(t[0], t[2]), max(t[1], t[3]));
+}
+
+// Gather all lanes, with a defined source (see above).
+SIMD_TARGET("avx512f")
+inline __m512 gatherAvx512(__m512i i, const float *x) {
+  return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), __mmask16(0xFFFF), i, x, 4);
+}
+#endif
+
+
+
+
+// SUM-VALUES-AT
+// -------------
+// Sum of x[is[j]], for j in [0, N).
+
+template <class T>
+inline T sumValuesAtScalar(const T *x, const int *is, size_t N, T a=T()) {
+  for (size_t j=0; j<N; ++j)
+    a += x[is[j]];
+  return a;
+}
+
+
+#ifdef SIMD_X86
+SIMD_TARGET("avx2")
+inline float sumValuesAtAvx2(const float *x, const int *is, size_t N) {
+  __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+  size_t j = 0;
+  for (; j+16<=N; j+=16) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    __m256i i1 = _mm256_loadu_si256((const __m256i*) (is+j+8));
+    a0 = _mm256_add_ps(a0, _mm256_i32gather_ps(x, i0, 4));
+    a1 = _mm256_add_ps(a1, _mm256_i32gather_ps(x, i1, 4));
+  }
+  for (; j+8<=N; j+=8) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    a0 = _mm256_add_ps(a0, _mm256_i32gather_ps(x, i0, 4));
+  }
+  float a = sumAvx2(_mm256_add_ps(a0, a1));
+  for (; j<N; ++j)
+    a += x[is[j]];
+  return a;
+}
+SIMD_TARGET("avx2")
+inline double sumValuesAtAvx2(const double *x, const int *is, size_t N) {
+  __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+  size_t j = 0;
+  for (; j+8<=N; j+=8) {
+    __m128i i0 = _mm_loadu_si128((const __m128i*) (is+j));
+    __m128i i1 = _mm_loadu_si128((const __m128i*) (is+j+4));
+    a0 = _mm256_add_pd(a0, _mm256_i32gather_pd(x, i0, 8));
+    a1 = _mm256_add_pd(a1, _mm256_i32gather_pd(x, i1, 8));
+  }
+  for (; j+4<=N; j+=4) {
+    __m128i i0 = _mm_loadu_si128((const __m128i*) (is+j));
+    a0 = _mm256_add_pd(a0, _mm256_i32gather_pd(x, i0, 8));
+  }
+  double a = sumAvx2(_mm256_add_pd(a0, a1));
+  for (; j<N; ++j)
+    a += x[is[j]];
+  return a;
+}
+
+
+SIMD_TARGET("avx512f")
+inline float sumValuesAtAvx512(const float *x, const int *is, size_t N) {
+  __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+  size_t j = 0;
+  for (; j+32<=N; j+=32) {
+    __m512i i0 = _mm512_loadu_si512(is+j);
+    __m512i i1 = _mm512_loadu_si512(is+j+16);
+    a0 = _mm512_add_ps(a0, gatherAvx512(i0, x));
+    a1 = _mm512_add_ps(a1, gatherAvx512(i1, x));
+  }
+  if (j<N) {
+    __mmask16 m  = N-j>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-j)) - 1);
+    __m512i   i0 = _mm512_maskz_loadu_epi32(m, is+j);
+    a0 = _mm512_add_ps(a0, _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, i0, x, 4));
+    j += 16;
+  }
+  if (j<N) {
+    __mmask16 m  = __mmask16((1u << (N-j)) - 1);
+    __m512i   i1 = _mm512_maskz_loadu_epi32(m, is+j);
+    a1 = _mm512_add_ps(a1, _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, i1, x, 4));
+  }
+  return sumAvx512(_mm512_add_ps(a0, a1));
+}
+SIMD_TARGET("avx512f")
+inline double sumValuesAtAvx512(const double *x, const int *is, size_t N) {
+  __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+  size_t j = 0;
+  for (; j+16<=N; j+=16) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    __m256i i1 = _mm256_loadu_si256((const __m256i*) (is+j+8));
+    a0 = _mm512_add_pd(a0, _mm512_i32gather_pd(i0, x, 8));
+    a1 = _mm512_add_pd(a1, _mm512_i32gather_pd(i1, x, 8));
+  }
+  for (; j<N; j+=8) {
+    __mmask8 m  = N-j>=8? __mmask8(0xFF) : __mmask8((1u << (N-j)) - 1);
+    __m256i  i0 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(m, is+j));
+    a0 = _mm512_add_pd(a0, _mm512_mask_i32gather_pd(_mm512_setzero_pd(), m, i0, x, 8));
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(a0, a1));
+}
+#endif
+
+
+template <class T>
+inline T sumValuesAtSimd(const T *x, const int *is, size_t N, T a=T()) {
+  return sumValuesAtScalar(x, is, N, a);
+}
+#ifdef SIMD_X86
+inline float sumValuesAtSimd(const float *x, const int *is, size_t N, float a=float()) {
+  if (N<SIZE_MIN_SIMD) return sumValuesAtScalar(x, is, N, a);
+  switch (simdLevel()) {
+    case 2:  return a + sumValuesAtAvx512(x, is, N);
+    case 1:  return a + sumValuesAtAvx2(x, is, N);
+    default: return sumValuesAtScalar(x, is, N, a);
+  }
+}
+inline double sumValuesAtSimd(const double *x, const int *is, size_t N, double a=double()) {
+  if (N<SIZE_MIN_SIMD) return sumValuesAtScalar(x, is, N, a);
+  switch (simdLevel()) {
+    case 2:  return a + sumValuesAtAvx512(x, is, N);
+    case 1:  return a + sumValuesAtAvx2(x, is, N);
+    default: return sumValuesAtScalar(x, is, N, a);
+  }
+}
+#endif
+
+
+
+
+// SUM-PRODUCTS-AT
+// ---------------
+// Sum of x[is[j]] * y[is[j]], for j in [0, N).
+
+template <class T>
+inline T sumProductsAtScalar(const T *x, const T *y, const int *is, size_t N, T a=T()) {
+  for (size_t j=0; j<N; ++j)
+    a += x[is[j]] * y[is[j]];
+  return a;
+}
+
+
+#ifdef SIMD_X86
+SIMD_TARGET("avx2,fma")
+inline float sumProductsAtAvx2(const float *x, const float *y, const int *is, size_t N) {
+  __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+  size_t j = 0;
+  for (; j+16<=N; j+=16) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    __m256i i1 = _mm256_loadu_si256((const __m256i*) (is+j+8));
+    a0 = _mm256_fmadd_ps(_mm256_i32gather_ps(x, i0, 4), _mm256_i32gather_ps(y, i0, 4), a0);
+    a1 = _mm256_fmadd_ps(_mm256_i32gather_ps(x, i1, 4), _mm256_i32gather_ps(y, i1, 4), a1);
+  }
+  for (; j+8<=N; j+=8) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    a0 = _mm256_fmadd_ps(_mm256_i32gather_ps(x, i0, 4), _mm256_i32gather_ps(y, i0, 4), a0);
+  }
+  float a = sumAvx2(_mm256_add_ps(a0, a1));
+  for (; j<N; ++j)
+    a += x[is[j]] * y[is[j]];
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double sumProductsAtAvx2(const double *x, const double *y, const int *is, size_t N) {
+  __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+  size_t j = 0;
+  for (; j+8<=N; j+=8) {
+    __m128i i0 = _mm_loadu_si128((const __m128i*) (is+j));
+    __m128i i1 = _mm_loadu_si128((const __m128i*) (is+j+4));
+    a0 = _mm256_fmadd_pd(_mm256_i32gather_pd(x, i0, 8), _mm256_i32gather_pd(y, i0, 8), a0);
+    a1 = _mm256_fmadd_pd(_mm256_i32gather_pd(x, i1, 8), _mm256_i32gather_pd(y, i1, 8), a1);
+  }
+  for (; j+4<=N; j+=4) {
+    __m128i i0 = _mm_loadu_si128((const __m128i*) (is+j));
+    a0 = _mm256_fmadd_pd(_mm256_i32gather_pd(x, i0, 8), _mm256_i32gather_pd(y, i0, 8), a0);
+  }
+  double a = sumAvx2(_mm256_add_pd(a0, a1));
+  for (; j<N; ++j)
+    a += x[is[j]] * y[is[j]];
+  return a;
+}
+
+
+SIMD_TARGET("avx512f")
+inline float sumProductsAtAvx512(const float *x, const float *y, const int *is, size_t N) {
+  __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+  size_t j = 0;
+  for (; j+32<=N; j+=32) {
+    __m512i i0 = _mm512_loadu_si512(is+j);
+    __m512i i1 = _mm512_loadu_si512(is+j+16);
+    a0 = _mm512_fmadd_ps(gatherAvx512(i0, x), gatherAvx512(i0, y), a0);
+    a1 = _mm512_fmadd_ps(gatherAvx512(i1, x), gatherAvx512(i1, y), a1);
+  }
+  for (; j<N; j+=16) {
+    __mmask16 m  = N-j>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-j)) - 1);
+    __m512i   i0 = _mm512_maskz_loadu_epi32(m, is+j);
+    __m512    x0 = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, i0, x, 4);
+    __m512    y0 = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, i0, y, 4);
+    a0 = _mm512_fmadd_ps(x0, y0, a0);
+  }
+  return sumAvx512(_mm512_add_ps(a0, a1));
+}
+SIMD_TARGET("avx512f")
+inline double sumProductsAtAvx512(const double *x, const double *y, const int *is, size_t N) {
+  __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+  size_t j = 0;
+  for (; j+16<=N; j+=16) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*) (is+j));
+    __m256i i1 = _mm256_loadu_si256((const __m256i*) (is+j+8));
+    a0 = _mm512_fmadd_pd(_mm512_i32gather_pd(i0, x, 8), _mm512_i32gather_pd(i0, y, 8), a0);
+    a1 = _mm512_fmadd_pd(_mm512_i32gather_pd(i1, x, 8), _mm512_i32gather_pd(i1, y, 8), a1);
+  }
+  for (; j<N; j+=8) {
+    __mmask8 m  = N-j>=8? __mmask8(0xFF) : __mmask8((1u << (N-j)) - 1);
+    __m256i  i0 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(m, is+j));
+    __m512d  x0 = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), m, i0, x, 8);
+    __m512d  y0 = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), m, i0, y, 8);
+    a0 = _mm512_fmadd_pd(x0, y0, a0);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(a0, a1));
+}
+#endif
+
+
+template <class T>
+inline T sumProductsAtSimd(const T *x, const T *y, const int *is, size_t N, T a=T()) {
+  return sumProductsAtScalar(x, y, is, N, a);
+}
+#ifdef SIMD_X86
+inline float sumProductsAtSimd(const float *x, const float *y, const int *is, size_t N, float a=float()) {
+  if (N<SIZE_MIN_SIMD) return sumProductsAtScalar(x, y, is, N, a);
+  switch (simdLevel()) {
+    case 2:  return a + sumProductsAtAvx512(x, y, is, N);
+    case 1:  return a + sumProductsAtAvx2(x, y, is, N);
+    default: return sumProductsAtScalar(x, y, is, N, a);
+  }
+}
+inline double sumProductsAtSimd(const double *x, const double *y, const int *is, size_t N, double a=double()) {
+  if (N<SIZE_MIN_SIMD) return sumProductsAtScalar(x, y, is, N, a);
+  switch (simdLevel()) {
+    case 2:  return a + sumProductsAtAvx512(x, y, is, N);
+    case 1:  return a + sumProductsAtAvx2(x, y, is, N);
+    default: return sumProductsAtScalar(x, y, is, N, a);
+  }
+}
+#endif
+
+
+
+
+// SUM-VALUES-AT, SUM-PRODUCTS-AT (BLOCKED)
+// ----------------------------------------
+// For gathers over a single long index list (such as the in-edges of a hub
+// vertex), split into blocks reduced by all threads.
+
+template <class T>
+T sumValuesAtSimdOmp(const T *x, const int *is, size_t N, T a=T()) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return sumValuesAtSimd(x, is, N, a);
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumValuesAtSimd(x, is+b, min(B, N-b));
+  return a;
+}
+
+template <class T>
+T sumProductsAtSimdOmp(const T *x, const T *y, const int *is, size_t N, T a=T()) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return sumProductsAtSimd(x, y, is, N, a);
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumProductsAtSimd(x, y, is+b, min(B, N-b));
+  return a;
+}
+
+
+
+
+// SUM-ABS-VALUES, SUM-SQR-VALUES, MAX-ABS-VALUE
+// ---------------------------------------------
+// For L1, L2, L∞ norms.
+
+#ifdef SIMD_X86
+SIMD_TARGET("avx2,fma")
+inline float sumAbsValuesAvx2(const float *x, size_t N) {
+  __m256 s = _mm256_set1_ps(-0.0f), a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8)
+    a0 = _mm256_add_ps(a0, _mm256_andnot_ps(s, _mm256_loadu_ps(x+i)));
+  float a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += abs(x[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double sumAbsValuesAvx2(const double *x, size_t N) {
+  __m256d s = _mm256_set1_pd(-0.0), a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4)
+    a0 = _mm256_add_pd(a0, _mm256_andnot_pd(s, _mm256_loadu_pd(x+i)));
+  double a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += abs(x[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline float sumSqrValuesAvx2(const float *x, size_t N) {
+  __m256 a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8) {
+    __m256 v = _mm256_loadu_ps(x+i);
+    a0 = _mm256_fmadd_ps(v, v, a0);
+  }
+  float a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += x[i]*x[i];
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double sumSqrValuesAvx2(const double *x, size_t N) {
+  __m256d a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4) {
+    __m256d v = _mm256_loadu_pd(x+i);
+    a0 = _mm256_fmadd_pd(v, v, a0);
+  }
+  double a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += x[i]*x[i];
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline float maxAbsValueAvx2(const float *x, size_t N) {
+  __m256 s = _mm256_set1_ps(-0.0f), a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8)
+    a0 = _mm256_max_ps(a0, _mm256_andnot_ps(s, _mm256_loadu_ps(x+i)));
+  float a = maxAvx2(a0);
+  for (; i<N; ++i)
+    a = max(a, abs(x[i]));
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double maxAbsValueAvx2(const double *x, size_t N) {
+  __m256d s = _mm256_set1_pd(-0.0), a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4)
+    a0 = _mm256_max_pd(a0, _mm256_andnot_pd(s, _mm256_loadu_pd(x+i)));
+  double a = maxAvx2(a0);
+  for (; i<N; ++i)
+    a = max(a, abs(x[i]));
+  return a;
+}
+
+
+SIMD_TARGET("avx512f")
+inline float sumAbsValuesAvx512(const float *x, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    a0 = _mm512_add_ps(a0, _mm512_abs_ps(_mm512_maskz_loadu_ps(m, x+i)));
+  }
+  return sumAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double sumAbsValuesAvx512(const double *x, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    a0 = _mm512_add_pd(a0, _mm512_abs_pd(_mm512_maskz_loadu_pd(m, x+i)));
+  }
+  return _mm512_reduce_add_pd(a0);
+}
+SIMD_TARGET("avx512f")
+inline float sumSqrValuesAvx512(const float *x, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    __m512    v = _mm512_maskz_loadu_ps(m, x+i);
+    a0 = _mm512_fmadd_ps(v, v, a0);
+  }
+  return sumAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double sumSqrValuesAvx512(const double *x, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    __m512d  v = _mm512_maskz_loadu_pd(m, x+i);
+    a0 = _mm512_fmadd_pd(v, v, a0);
+  }
+  return _mm512_reduce_add_pd(a0);
+}
+SIMD_TARGET("avx512f")
+inline float maxAbsValueAvx512(const float *x, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    a0 = _mm512_mask_max_ps(a0, __mmask16(0xFFFF), a0, _mm512_abs_ps(_mm512_maskz_loadu_ps(m, x+i)));
+  }
+  return maxAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double maxAbsValueAvx512(const double *x, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    a0 = _mm512_max_pd(a0, _mm512_abs_pd(_mm512_maskz_loadu_pd(m, x+i)));
+  }
+  return _mm512_reduce_max_pd(a0);
+}
+#endif
+
+
+template <class T>
+inline T sumAbsValuesSimd(const T *x, size_t N) {
+  return sumAbsValues(x, N);
+}
+template <class T>
+inline T sumSqrValuesSimd(const T *x, size_t N) {
+  return sumSqrValues(x, N);
+}
+template <class T>
+inline T maxAbsValueSimd(const T *x, size_t N) {
+  return maxAbsValue(x, N);
+}
+
+#ifdef SIMD_X86
+#define SIMD_DISPATCH_REDUCE(F, T) \
+  inline T F##Simd(const T *x, size_t N) { \
+    switch (simdLevel()) { \
+      case 2:  return F##Avx512(x, N); \
+      case 1:  return F##Avx2(x, N); \
+      default: return F(x, N); \
+    } \
+  }
+
+SIMD_DISPATCH_REDUCE(sumAbsValues, float)
+SIMD_DISPATCH_REDUCE(sumAbsValues, double)
+SIMD_DISPATCH_REDUCE(sumSqrValues, float)
+SIMD_DISPATCH_REDUCE(sumSqrValues, double)
+SIMD_DISPATCH_REDUCE(maxAbsValue,  float)
+SIMD_DISPATCH_REDUCE(maxAbsValue,  double)
+#endif
+
+
+
+
+// SUM-ABS-DIFFERENCES, SUM-SQR-DIFFERENCES, MAX-ABS-DIFFERENCE
+// -----------------------------------------------------------
+// For L1, L2, L∞ norms of x - y.
+
+template <class T>
+inline T sumAbsDifferences(const T *x, const T *y, size_t N) {
+  T a = T();
+  for (size_t i=0; i<N; ++i)
+    a += abs(x[i] - y[i]);
+  return a;
+}
+template <class T>
+inline T sumSqrDifferences(const T *x, const T *y, size_t N) {
+  T a = T();
+  for (size_t i=0; i<N; ++i)
+    a += (x[i] - y[i]) * (x[i] - y[i]);
+  return a;
+}
+template <class T>
+inline T maxAbsDifference(const T *x, const T *y, size_t N) {
+  T a = T();
+  for (size_t i=0; i<N; ++i)
+    a = max(a, abs(x[i] - y[i]));
+  return a;
+}
+
+
+#ifdef SIMD_X86
+SIMD_TARGET("avx2,fma")
+inline float sumAbsDifferencesAvx2(const float *x, const float *y, size_t N) {
+  __m256 s = _mm256_set1_ps(-0.0f), a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8)
+    a0 = _mm256_add_ps(a0, _mm256_andnot_ps(s, _mm256_sub_ps(_mm256_loadu_ps(x+i), _mm256_loadu_ps(y+i))));
+  float a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += abs(x[i] - y[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double sumAbsDifferencesAvx2(const double *x, const double *y, size_t N) {
+  __m256d s = _mm256_set1_pd(-0.0), a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4)
+    a0 = _mm256_add_pd(a0, _mm256_andnot_pd(s, _mm256_sub_pd(_mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i))));
+  double a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += abs(x[i] - y[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline float sumSqrDifferencesAvx2(const float *x, const float *y, size_t N) {
+  __m256 a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8) {
+    __m256 v = _mm256_sub_ps(_mm256_loadu_ps(x+i), _mm256_loadu_ps(y+i));
+    a0 = _mm256_fmadd_ps(v, v, a0);
+  }
+  float a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += (x[i] - y[i]) * (x[i] - y[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double sumSqrDifferencesAvx2(const double *x, const double *y, size_t N) {
+  __m256d a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4) {
+    __m256d v = _mm256_sub_pd(_mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i));
+    a0 = _mm256_fmadd_pd(v, v, a0);
+  }
+  double a = sumAvx2(a0);
+  for (; i<N; ++i)
+    a += (x[i] - y[i]) * (x[i] - y[i]);
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline float maxAbsDifferenceAvx2(const float *x, const float *y, size_t N) {
+  __m256 s = _mm256_set1_ps(-0.0f), a0 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i+8<=N; i+=8)
+    a0 = _mm256_max_ps(a0, _mm256_andnot_ps(s, _mm256_sub_ps(_mm256_loadu_ps(x+i), _mm256_loadu_ps(y+i))));
+  float a = maxAvx2(a0);
+  for (; i<N; ++i)
+    a = max(a, abs(x[i] - y[i]));
+  return a;
+}
+SIMD_TARGET("avx2,fma")
+inline double maxAbsDifferenceAvx2(const double *x, const double *y, size_t N) {
+  __m256d s = _mm256_set1_pd(-0.0), a0 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i+4<=N; i+=4)
+    a0 = _mm256_max_pd(a0, _mm256_andnot_pd(s, _mm256_sub_pd(_mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i))));
+  double a = maxAvx2(a0);
+  for (; i<N; ++i)
+    a = max(a, abs(x[i] - y[i]));
+  return a;
+}
+
+
+SIMD_TARGET("avx512f")
+inline float sumAbsDifferencesAvx512(const float *x, const float *y, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    a0 = _mm512_add_ps(a0, _mm512_abs_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x+i), _mm512_maskz_loadu_ps(m, y+i))));
+  }
+  return sumAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double sumAbsDifferencesAvx512(const double *x, const double *y, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    a0 = _mm512_add_pd(a0, _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, x+i), _mm512_maskz_loadu_pd(m, y+i))));
+  }
+  return _mm512_reduce_add_pd(a0);
+}
+SIMD_TARGET("avx512f")
+inline float sumSqrDifferencesAvx512(const float *x, const float *y, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    __m512    v = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, x+i), _mm512_maskz_loadu_ps(m, y+i));
+    a0 = _mm512_fmadd_ps(v, v, a0);
+  }
+  return sumAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double sumSqrDifferencesAvx512(const double *x, const double *y, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    __m512d  v = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, x+i), _mm512_maskz_loadu_pd(m, y+i));
+    a0 = _mm512_fmadd_pd(v, v, a0);
+  }
+  return _mm512_reduce_add_pd(a0);
+}
+SIMD_TARGET("avx512f")
+inline float maxAbsDifferenceAvx512(const float *x, const float *y, size_t N) {
+  __m512 a0 = _mm512_setzero_ps();
+  for (size_t i=0; i<N; i+=16) {
+    __mmask16 m = N-i>=16? __mmask16(0xFFFF) : __mmask16((1u << (N-i)) - 1);
+    a0 = _mm512_mask_max_ps(a0, __mmask16(0xFFFF), a0, _mm512_abs_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x+i), _mm512_maskz_loadu_ps(m, y+i))));
+  }
+  return maxAvx512(a0);
+}
+SIMD_TARGET("avx512f")
+inline double maxAbsDifferenceAvx512(const double *x, const double *y, size_t N) {
+  __m512d a0 = _mm512_setzero_pd();
+  for (size_t i=0; i<N; i+=8) {
+    __mmask8 m = N-i>=8? __mmask8(0xFF) : __mmask8((1u << (N-i)) - 1);
+    a0 = _mm512_max_pd(a0, _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, x+i), _mm512_maskz_loadu_pd(m, y+i))));
+  }
+  return _mm512_reduce_max_pd(a0);
+}
+#endif
+
+
+template <class T>
+inline T sumAbsDifferencesSimd(const T *x, const T *y, size_t N) {
+  return sumAbsDifferences(x, y, N);
+}
+template <class T>
+inline T sumSqrDifferencesSimd(const T *x, const T *y, size_t N) {
+  return sumSqrDifferences(x, y, N);
+}
+template <class T>
+inline T maxAbsDifferenceSimd(const T *x, const T *y, size_t N) {
+  return maxAbsDifference(x, y, N);
+}
+
+#ifdef SIMD_X86
+#define SIMD_DISPATCH_REDUCE2(F, T) \
+  inline T F##Simd(const T *x, const T *y, size_t N) { \
+    switch (simdLevel()) { \
+      case 2:  return F##Avx512(x, y, N); \
+      case 1:  return F##Avx2(x, y, N); \
+      default: return F(x, y, N); \
+    } \
+  }
+
+SIMD_DISPATCH_REDUCE2(sumAbsDifferences, float)
+SIMD_DISPATCH_REDUCE2(sumAbsDifferences, double)
+SIMD_DISPATCH_REDUCE2(sumSqrDifferences, float)
+SIMD_DISPATCH_REDUCE2(sumSqrDifferences, double)
+SIMD_DISPATCH_REDUCE2(maxAbsDifference,  float)
+SIMD_DISPATCH_REDUCE2(maxAbsDifference,  double)
+#endif
+
+
+
+
+// L1-NORM, L2-NORM, LI-NORM
+// -------------------------
+
+template <class T>
+inline T l1NormSimd(const vector<T>& x, size_t i, size_t N) {
+  return sumAbsValuesSimd(x.data()+i, N);
+}
+template <class T>
+inline T l2NormSimd(const vector<T>& x, size_t i, size_t N) {
+  return sqrt(sumSqrValuesSimd(x.data()+i, N));
+}
+template <class T>
+inline T liNormSimd(const vector<T>& x, size_t i, size_t N) {
+  return maxAbsValueSimd(x.data()+i, N);
+}
+
+template <class T>
+inline T l1NormSimd(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  return sumAbsDifferencesSimd(x.data()+i, y.data()+i, N);
+}
+template <class T>
+inline T l2NormSimd(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  return sqrt(sumSqrDifferencesSimd(x.data()+i, y.data()+i, N));
+}
+template <class T>
+inline T liNormSimd(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  return maxAbsDifferenceSimd(x.data()+i, y.data()+i, N);
+}
+
+
+// Each thread reduces a contiguous block with SIMD.
+template <class T>
+T l1NormSimdOmp(const vector<T>& x, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return l1NormSimd(x, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumAbsValuesSimd(x.data()+i+b, min(B, N-b));
+  return a;
+}
+template <class T>
+T l2NormSimdOmp(const vector<T>& x, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return l2NormSimd(x, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumSqrValuesSimd(x.data()+i+b, min(B, N-b));
+  return sqrt(a);
+}
+template <class T>
+T liNormSimdOmp(const vector<T>& x, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return liNormSimd(x, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(max:a)
+  for (size_t b=0; b<N; b+=B)
+    a = max(a, maxAbsValueSimd(x.data()+i+b, min(B, N-b)));
+  return a;
+}
+
+
+template <class T>
+T l1NormSimdOmp(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return l1NormSimd(x, y, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumAbsDifferencesSimd(x.data()+i+b, y.data()+i+b, min(B, N-b));
+  return a;
+}
+template <class T>
+T l2NormSimdOmp(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return l2NormSimd(x, y, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(+:a)
+  for (size_t b=0; b<N; b+=B)
+    a += sumSqrDifferencesSimd(x.data()+i+b, y.data()+i+b, min(B, N-b));
+  return sqrt(a);
+}
+template <class T>
+T liNormSimdOmp(const vector<T>& x, const vector<T>& y, size_t i, size_t N) {
+  const size_t B = SIZE_BLOCK_SIMD_OMP;
+  if (N<SIZE_MIN_OMPR) return liNormSimd(x, y, i, N);
+  T a = T();
+  #pragma omp parallel for schedule(static) reduction(max:a)
+  for (size_t b=0; b<N; b+=B)
+    a = max(a, maxAbsDifferenceSimd(x.data()+i+b, y.data()+i+b, min(B, N-b)));
+  return a;
+}
@@ -9,6 +9,7 @@
 #include "components.hxx"
 
 using std::iterator_traits;
+using std::pair;
 using std::vector;
 using std::unordered_set;
 using std::make_pair;
@@ -38,6 +39,38 @@ auto adjustRanks(size_t N, const vector<T>& r, const J& ks0, const J& ks1, T rad
 
 
 
+// APPLY-EDGE-BATCH
+// ----------------
+// Delete, insert edges in place, on a graph and its transpose (with
+// vertex-data=out-degree). Edges already absent/present are skipped.
+// Returns vertices whose in-edges changed, and whose out-degree changed.
+
+template <class G, class H, class K>
+auto applyEdgeBatchU(G& x, H& xt, const vector<pair<K, K>>& del, const vector<pair<K, K>>& ins) {
+  vector<K> vs, us;
+  for (auto [u, v] : del) {
+    if (!x.hasEdge(u, v)) continue;
+    x.removeEdge(u, v); xt.removeEdge(v, u);
+    vs.push_back(v); us.push_back(u);
+  }
+  for (auto [u, v] : ins) {
+    if (x.hasEdge(u, v)) continue;
+    x.addEdge(u, v); xt.addEdge(v, u);
+    vs.push_back(v); us.push_back(u);
+  }
+  vs.resize(sortedUnique(vs));
+  us.resize(sortedUnique(us));
+  // Only edge lists of touched vertices need to be sorted again.
+  for (auto v : vs) { x.correctVertex(v); xt.correctVertex(v); }
+  for (auto u : us) { x.correctVertex(u); xt.correctVertex(u); }
+  for (auto u : us)
+    xt.setVertexValue(u, K(x.degree(u)));
+  return make_pair(vs, us);
+}
+
+
+
+
 // CHANGED-VERTICES
 // ----------------
 // Find vertices with edges added/removed.
@@ -18,6 +18,7 @@
 #include "identicals.hxx"
 #include "chains.hxx"
 #include "dynamic.hxx"
+#include "random.hxx"
 #include "pagerank.hxx"
 #include "pagerankSeq.hxx"
 #include "pagerankOmp.hxx"
@@ -3,16 +3,29 @@
 #include <istream>
 #include <sstream>
 #include <fstream>
+#include <utility>
+#include <vector>
+#include <numeric>
 #include <algorithm>
+#include <climits>
+#include <limits>
 #include "_main.hxx"
 #include "Graph.hxx"
 
+using std::pair;
+using std::vector;
 using std::string;
 using std::istream;
 using std::stringstream;
 using std::ofstream;
 using std::getline;
 using std::max;
+using std::min;
+using std::sort;
+using std::unique;
+using std::partial_sum;
+using std::accumulate;
+using std::numeric_limits;
 
 
 
@@ -90,6 +103,138 @@ READ_MTX_RETURN(Graph, false)
 
 
 
+// READ-MTX-TRANSPOSE-CSR
+// ----------------------
+// Read transpose of graph as CSR, in parallel from a memory mapped file.
+// Vertex keys 1..n map to indices 0..n-1; in-edges are sorted, without duplicates.
+
+inline const char* readMtxSkipLine(const char *p, const char *e) {
+  while (p<e && *p!='\n') ++p;
+  return p<e? p+1 : e;
+}
+
+inline const char* readMtxNumber(const char *p, const char *e, size_t& a) {
+  while (p<e && (*p==' ' || *p=='\t')) ++p;
+  a = 0;
+  const char *b = p;
+  for (; p<e && *p>='0' && *p<='9'; ++p)
+    a = a*10 + (*p-'0');
+  return p==b? nullptr : p;
+}
+
+
+// Parse edges (from, to) of lines in [p, e) as (source, target) indices.
+// Edges with a vertex outside 1..n are skipped.
+// @returns number of edges skipped
+inline size_t readMtxEdgesDo(const char *p, const char *e, bool sym, size_t n, vector<pair<int, int>>& a) {
+  size_t bad = 0;
+  while (p<e) {
+    size_t u, v;
+    const char *q = p;
+    if (*q=='%') { p = readMtxSkipLine(p, e); continue; }
+    if (!(q = readMtxNumber(q, e, u)) || !(q = readMtxNumber(q, e, v))) { p = readMtxSkipLine(p, e); continue; }
+    p = readMtxSkipLine(q, e);
+    if (u==0 || v==0 || u>n || v>n) { ++bad; continue; }
+    a.push_back({int(u-1), int(v-1)});
+    if (sym && u!=v) a.push_back({int(v-1), int(u-1)});
+  }
+  return bad;
+}
+
+
+// @param vfrom in-edge offsets of each vertex (output)
+// @param efrom source index of each in-edge (output)
+// @param vdata out-degree of each vertex (output)
+// @param pth   path to mtx file
+// @param loop  add self-loop to each vertex?
+// @returns success? (fails if any edge has a vertex outside 1..n, or offsets are too narrow)
+template <class I>
+inline bool readMtxTransposeCsrOmpW(vector<I>& vfrom, vector<int>& efrom, vector<int>& vdata, const char *pth, bool loop=false) {
+  MappedFile f(pth);
+  if (f.empty()) return false;
+  const char *p = f.data(), *e = p + f.size();
+  // Read header
+  string h0, h1, h2, h3, h4;
+  for (; p<e && *p=='%'; p=readMtxSkipLine(p, e)) {
+    if (p+1>=e || p[1]!='%') continue;
+    stringstream ls(string(p, readMtxSkipLine(p, e)));
+    ls >> h0 >> h1 >> h2 >> h3 >> h4;
+  }
+  if (h1!="matrix" || h2!="coordinate") return false;
+  bool sym = h4=="symmetric" || h4=="skew-symmetric";
+  // Read rows, cols, size
+  size_t r, c, sz; const char *q = p;
+  if (!(q = readMtxNumber(q, e, r)) || !(q = readMtxNumber(q, e, c)) || !readMtxNumber(q, e, sz)) return false;
+  p = readMtxSkipLine(q, e);
+  if (max(r, c) > size_t(INT_MAX)) return false;
+  int n = int(max(r, c));
+  // Read edges, each thread from a chunk of lines
+  int  TS = omp_get_max_threads();
+  auto DP = (e-p + TS-1) / TS;
+  vector<const char*> ps(TS+1);
+  for (int t=0; t<TS; t++)
+    ps[t] = t==0? p : readMtxSkipLine(min(p + t*DP - 1, e), e);
+  ps[TS] = e;
+  vector<vector<pair<int, int>>> es(TS);
+  size_t bad = 0;
+  #pragma omp parallel for schedule(static, 1) reduction(+:bad)
+  for (int t=0; t<TS; t++) {
+    es[t].reserve((sym? 2 : 1) * sz/TS + 1);
+    if (ps[t]<ps[t+1]) bad += readMtxEdgesDo(ps[t], ps[t+1], sym, n, es[t]);
+  }
+  if (bad>0) return false;
+  // Count in-edges, and place them
+  vector<size_t> pos(n+1);
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; t++) {
+    for (auto [u, v] : es[t]) {
+      #pragma omp atomic
+      ++pos[v+1];
+    }
+  }
+  if (loop) { for (int v=0; v<n; v++) ++pos[v+1]; }
+  partial_sum(pos.begin(), pos.end(), pos.begin());
+  vector<int> ef(pos[n]);
+  vector<size_t> vf(pos);
+  if (loop) { for (int v=0; v<n; v++) ef[pos[v]++] = v; }
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; t++) {
+    for (auto [u, v] : es[t]) {
+      size_t i;
+      #pragma omp atomic capture
+      i = pos[v]++;
+      ef[i] = u;
+    }
+    vector<pair<int, int>>().swap(es[t]);
+  }
+  // Sort in-edges, and remove duplicates
+  vfrom.assign(n+1, 0);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (int v=0; v<n; v++) {
+    auto ib = ef.begin() + vf[v], ie = ef.begin() + vf[v+1];
+    sort(ib, ie);
+    vfrom[v+1] = unique(ib, ie) - ib;
+  }
+  if (accumulate(vfrom.begin(), vfrom.end(), size_t()) > size_t(numeric_limits<I>::max())) return false;
+  partial_sum(vfrom.begin(), vfrom.end(), vfrom.begin());
+  efrom.resize(vfrom[n]);
+  vdata.assign(n, 0);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (int v=0; v<n; v++) {
+    size_t j = vfrom[v];
+    for (size_t i=vf[v], ie=vf[v]+(vfrom[v+1]-vfrom[v]); i<ie; ++i) {
+      int u = ef[i];
+      efrom[j++] = u;
+      #pragma omp atomic
+      ++vdata[u];
+    }
+  }
+  return true;
+}
+
+
+
+
 // WRITE-MTX
 // ---------
 
@@ -1,10 +1,36 @@
 #pragma once
 #include <vector>
+#include <string>
+#include <ostream>
 #include <utility>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <limits>
+#include <fstream>
+#include <type_traits>
 #include "_main.hxx"
+#include "mtx.hxx"
+#include "reorder.hxx"
 
 using std::vector;
+using std::string;
+using std::ostream;
+using std::ofstream;
+using std::memcpy;
 using std::move;
+using std::partial_sum;
+using std::copy;
+using std::numeric_limits;
+using std::copy_backward;
+using std::unique;
+using std::any_of;
+using std::upper_bound;
+using std::min;
+using std::sort;
+using std::make_pair;
 
 
 
@@ -19,14 +45,84 @@ struct PagerankOptions {
   T    damping;
   T    tolerance;
   int  maxIterations;
+  int  partition;  // 0=by vertices, 1=by in-edges (barrier-free)
+  bool steal;      // let finished threads take chunks of others (barrier-free)
+  bool global;     // stop all threads together, on convergence of all ranks (barrier-free)
+  int  reorder;    // 0=none, 1=by SCCs in topological order, 2=reverse Cuthill-McKee, 3=by in-degree
+  int  compress;   // 0=none, 1=delta-varint coded in-edge sources
+  int  precision;  // 0=rank type, 1=float contributions, 2=bf16 contributions (summed in double)
+  bool profile;    // record each sweep of each thread (barrier-free)
+  bool numa;       // pin threads, and place each thread's range on its node (barrier-free)
 
-  PagerankOptions(int repeat=1, int toleranceNorm=1, T damping=0.85, T tolerance=1e-6, int maxIterations=500) :
-  repeat(repeat), toleranceNorm(toleranceNorm), damping(damping), tolerance(tolerance), maxIterations(maxIterations) {}
+  PagerankOptions(int repeat=1, int toleranceNorm=1, T damping=0.85, T tolerance=1e-6, int maxIterations=500, int partition=0, bool steal=false, bool global=false, int reorder=0, int compress=0, int precision=0, bool profile=false, bool numa=false) :
+  repeat(repeat), toleranceNorm(toleranceNorm), damping(damping), tolerance(tolerance), maxIterations(maxIterations), partition(partition), steal(steal), global(global), reorder(reorder), compress(compress), precision(precision), profile(profile), numa(numa) {}
 };
 
 
 
 
+// PAGERANK-THREAD-RESULT
+// ----------------------
+// For per-thread statistics of barrier-free pagerank.
+
+struct PagerankThreadResult {
+  int   begin;       // first vertex owned (compressed index)
+  int   end;         // one past last vertex owned
+  int   iterations;  // sweeps over owned vertices
+  int   steals;      // chunks processed for other threads
+  float time;        // time spent calculating ranks (ms)
+  float idle;        // time spent waiting (ms)
+
+  PagerankThreadResult(int begin=0, int end=0, int iterations=0, int steals=0, float time=0, float idle=0) :
+  begin(begin), end(end), iterations(iterations), steals(steals), time(time), idle(idle) {}
+};
+
+
+
+
+// PAGERANK-SWEEP-RESULT
+// ---------------------
+// For per-thread, per-sweep profile of barrier-free pagerank.
+
+struct PagerankSweepResult {
+  int    thread;    // thread performing the sweep
+  int    sweep;     // sweep number of thread (from 1)
+  float  time;      // time elapsed at end of sweep (ms)
+  float  duration;  // time taken by sweep (ms)
+  size_t edges;     // in-edges processed in sweep
+  double error;     // error of ranks of thread's range
+  float  stale;     // mean no. of sweeps by which owners of in-edge sources lag behind
+  float  idle;      // time spent waiting in sweep (ms)
+
+  PagerankSweepResult(int thread=0, int sweep=0, float time=0, float duration=0, size_t edges=0, double error=0, float stale=0, float idle=0) :
+  thread(thread), sweep(sweep), time(time), duration(duration), edges(edges), error(error), stale(stale), idle(idle) {}
+};
+
+
+// Write sweeps as CSV, with given leading columns (p, comma-terminated) on each row.
+inline void writePagerankSweepsCsvHeader(ostream& a, const string& p="") {
+  a << p << "thread,sweep,time,duration,edges,error,stale,idle\n";
+}
+inline void writePagerankSweepsCsv(ostream& a, const vector<PagerankSweepResult>& xs, const string& p="") {
+  for (const auto& x : xs)
+    a << p << x.thread << ',' << x.sweep << ',' << x.time << ',' << x.duration << ',' << x.edges << ',' << x.error << ',' << x.stale << ',' << x.idle << '\n';
+}
+
+// Write sweeps as JSON array of objects.
+inline void writePagerankSweepsJson(ostream& a, const vector<PagerankSweepResult>& xs) {
+  a << '[';
+  for (size_t i=0; i<xs.size(); ++i) {
+    const auto& x = xs[i];
+    if (i>0) a << ',';
+    a << "{\"thread\":" << x.thread << ",\"sweep\":" << x.sweep << ",\"time\":" << x.time << ",\"duration\":" << x.duration;
+    a << ",\"edges\":" << x.edges << ",\"error\":" << x.error << ",\"stale\":" << x.stale << ",\"idle\":" << x.idle << '}';
+  }
+  a << ']';
+}
+
+
+
+
 // PAGERANK-RESULT
 // ---------------
 
@@ -35,6 +131,8 @@ struct PagerankResult {
   vector<T> ranks;
   int   iterations;
   float time;
+  vector<PagerankThreadResult> threads;
+  vector<PagerankSweepResult>  sweeps;
 
   PagerankResult(vector<T>&& ranks, int iterations=0, float time=0) :
   ranks(ranks), iterations(iterations), time(time) {}
@@ -52,3 +150,428 @@ struct PagerankResult {
     return {a, 0, 0};
   }
 };
+
+
+
+
+// PAGERANK-ORDER
+// --------------
+// Vertex order in which ranks are computed (vertices, start offset of each component).
+
+template <class G, class H>
+auto pagerankOrder(const G& x, const H& xt, int RO) {
+  using K = typename G::key_type;
+  switch (RO) {
+    case 1:  return componentsOrder(x, xt);
+    case 2:  return make_pair(reverseCuthillMckeeOrder(x, xt), vector<K>());
+    case 3:  return make_pair(inDegreeOrder(xt), vector<K>());
+    default: return make_pair(vertexKeys(xt), vector<K>());
+  }
+}
+
+
+
+
+// PAGERANK-PACKED
+// ---------------
+// Compact in-edges and contributions, to reduce memory traffic per iteration.
+// In-edge sources of each vertex are sorted and stored as varint deltas (the
+// first relative to the vertex itself, zigzag coded). Contributions (rank *
+// factor) of each vertex can be kept in float or bf16, and are summed in double.
+
+struct PagerankPacked {
+  int  compress  = 0;      // 0=none, 1=delta-varint coded in-edge sources
+  int  precision = 0;      // 0=rank type, 1=float contributions, 2=bf16 contributions
+  bool built     = false;  // in-edges coded for current CSR?
+  vector<uint8_t> ebytes;  // coded in-edge sources (compress=1)
+  vector<size_t>  bfrom;   // byte offset of in-edges of each vertex (compress=1)
+  const int *efrom = nullptr;  // plain in-edge sources (compress=0)
+  vector<float>    cf;     // contributions (precision=1), updated with ranks
+  vector<BFloat16> cb;     // contributions (precision=2), updated with ranks
+};
+
+
+inline int varintSize(size_t x) {
+  int a = 1;
+  for (; x>=0x80; x>>=7) ++a;
+  return a;
+}
+
+inline void writeVarint(uint8_t*& p, size_t x) {
+  for (; x>=0x80; x>>=7)
+    *p++ = uint8_t(x | 0x80);
+  *p++ = uint8_t(x);
+}
+
+inline size_t readVarint(const uint8_t*& p) {
+  size_t a = 0;
+  for (int s=0;; s+=7) {
+    uint8_t b = *p++;
+    a |= size_t(b & 0x7F) << s;
+    if (b<0x80) return a;
+  }
+}
+
+
+
+
+// PAGERANK-CSR
+// ------------
+// Compact transpose graph (in-edges) with preallocated buffers, for
+// repeated pagerank computation on the same graph. In-edge offsets are of
+// type I, which must hold the no. of edges (use size_t beyond 2^31 edges).
+
+template <class T, class I=int>
+struct PagerankCsr {
+  vector<int> ks;     // vertex key at each index
+  vector<int> ids;    // vertex index of each key (-1 if none)
+  vector<I>   vfrom;  // in-edge offsets of each vertex
+  vector<int> efrom;  // source vertex index of each in-edge
+  vector<int> vdata;  // out-degree of each vertex
+  vector<int> cfrom;  // start index of each component (optional)
+  vector<T> a, r, c, f, q;  // buffers for ranks, contributions, factors, initial ranks
+  PagerankPacked packed;    // compact in-edges, contributions (optional)
+  vector<int> placed;       // thread ranges placed on their NUMA nodes (optional)
+
+  inline int span()  const noexcept { return ids.size(); }
+  inline int order() const noexcept { return ks.size(); }
+  inline size_t size() const noexcept { return efrom.size(); }
+  inline const auto& vertexKeys() const noexcept { return ks; }
+};
+
+
+template <class T, class H, class J, class I>
+void pagerankCsrW(PagerankCsr<T, I>& a, const H& xt, const J& ks) {
+  int S = xt.span(), N = 0;
+  a.ks.clear();
+  a.cfrom.clear();
+  for (auto u : ks) { a.ks.push_back(int(u)); ++N; }
+  a.ids.assign(S, -1);
+  a.vfrom.resize(N+1);
+  a.vdata.resize(N);
+  for (int i=0; i<N; i++) {
+    int u = a.ks[i];
+    a.ids[u] = i;
+    a.vfrom[i+1] = xt.degree(u);
+    a.vdata[i]   = xt.vertexValue(u);
+  }
+  a.vfrom[0] = 0;
+  partial_sum(a.vfrom.begin(), a.vfrom.end(), a.vfrom.begin());
+  a.efrom.resize(a.vfrom[N]);
+  for (int i=0; i<N; i++) {
+    size_t j = a.vfrom[i];
+    xt.forEachEdgeKey(a.ks[i], [&](auto v) { a.efrom[j++] = a.ids[v]; });
+  }
+  a.a.resize(N); a.r.resize(N); a.c.resize(N); a.f.resize(N); a.q.resize(N);
+  a.packed = PagerankPacked();
+  a.placed.clear();
+}
+
+template <class T, class H, class J, class I>
+void pagerankCsrOmpW(PagerankCsr<T, I>& a, const H& xt, const J& ks) {
+  int S = xt.span(), N = 0;
+  a.ks.clear();
+  a.cfrom.clear();
+  for (auto u : ks) { a.ks.push_back(int(u)); ++N; }
+  a.ids.assign(S, -1);
+  a.vfrom.resize(N+1);
+  a.vdata.resize(N);
+  #pragma omp parallel for schedule(static, 2048)
+  for (int i=0; i<N; i++) {
+    int u = a.ks[i];
+    a.ids[u] = i;
+    a.vfrom[i+1] = xt.degree(u);
+    a.vdata[i]   = xt.vertexValue(u);
+  }
+  a.vfrom[0] = 0;
+  partial_sum(a.vfrom.begin(), a.vfrom.end(), a.vfrom.begin());
+  a.efrom.resize(a.vfrom[N]);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (int i=0; i<N; i++) {
+    size_t j = a.vfrom[i];
+    xt.forEachEdgeKey(a.ks[i], [&](auto v) { a.efrom[j++] = a.ids[v]; });
+  }
+  a.a.resize(N); a.r.resize(N); a.c.resize(N); a.f.resize(N); a.q.resize(N);
+  a.packed = PagerankPacked();
+  a.placed.clear();
+}
+
+
+// Build from transpose graph (with vertex-data=out-degree), in given vertex order.
+template <class T, class I=int, class H, class J>
+inline auto pagerankCsr(const H& xt, const J& ks) {
+  PagerankCsr<T, I> a; pagerankCsrW(a, xt, ks);
+  return a;
+}
+template <class T, class I=int, class H>
+inline auto pagerankCsr(const H& xt) {
+  return pagerankCsr<T, I>(xt, xt.vertexKeys());
+}
+
+template <class T, class I=int, class H, class J>
+inline auto pagerankCsrOmp(const H& xt, const J& ks) {
+  PagerankCsr<T, I> a; pagerankCsrOmpW(a, xt, ks);
+  return a;
+}
+template <class T, class I=int, class H>
+inline auto pagerankCsrOmp(const H& xt) {
+  return pagerankCsrOmp<T, I>(xt, xt.vertexKeys());
+}
+
+
+// Call fn with CSR built from transpose graph, with int offsets if they can
+// hold the no. of edges, otherwise with size_t offsets.
+template <class T, class H, class J, class F>
+inline auto pagerankCsrDo(const H& xt, const J& ks, F fn) {
+  if (xt.size() > size_t(INT_MAX)) { auto a = pagerankCsr<T, size_t>(xt, ks); return fn(a); }
+  auto a = pagerankCsr<T>(xt, ks);
+  return fn(a);
+}
+
+template <class T, class H, class J, class F>
+inline auto pagerankCsrOmpDo(const H& xt, const J& ks, F fn) {
+  if (xt.size() > size_t(INT_MAX)) { auto a = pagerankCsrOmp<T, size_t>(xt, ks); return fn(a); }
+  auto a = pagerankCsrOmp<T>(xt, ks);
+  return fn(a);
+}
+
+
+
+// Code in-edges of CSR (if not done), and size contribution buffers.
+template <class T, class I>
+void pagerankPackOmpW(PagerankPacked& a, const PagerankCsr<T, I>& x, int compress, int precision) {
+  int N = x.order();
+  a.efrom = x.efrom.data();
+  a.cf.resize(precision==1? N : 0);
+  a.cb.resize(precision==2? N : 0);
+  a.precision = precision;
+  if (a.built && a.compress==compress) return;
+  a.compress = compress;
+  a.built    = true;
+  a.ebytes.clear();
+  a.bfrom.clear();
+  if (!compress) return;
+  // Sort sources of each vertex, and find size of their codes.
+  vector<int> es(x.efrom);
+  auto fz = [](int u, int v) { int64_t d = int64_t(u) - v; return size_t((d << 1) ^ (d >> 63)); };
+  a.bfrom.assign(N+1, 0);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (int v=0; v<N; v++) {
+    auto ib = es.begin() + x.vfrom[v], ie = es.begin() + x.vfrom[v+1];
+    if (ib==ie) continue;
+    sort(ib, ie);
+    size_t b = varintSize(fz(*ib, v));
+    for (auto it=ib+1; it<ie; ++it)
+      b += varintSize(size_t(*it - *(it-1)));
+    a.bfrom[v+1] = b;
+  }
+  partial_sum(a.bfrom.begin(), a.bfrom.end(), a.bfrom.begin());
+  // Write codes of sources of each vertex.
+  a.ebytes.resize(a.bfrom[N]);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (int v=0; v<N; v++) {
+    auto ib = es.begin() + x.vfrom[v], ie = es.begin() + x.vfrom[v+1];
+    if (ib==ie) continue;
+    uint8_t *p = a.ebytes.data() + a.bfrom[v];
+    writeVarint(p, fz(*ib, v));
+    for (auto it=ib+1; it<ie; ++it)
+      writeVarint(p, size_t(*it - *(it-1)));
+  }
+}
+
+
+// Set contributions (rank * factor) of all vertices, in storage type.
+template <class T>
+void pagerankPackedContributionsW(PagerankPacked& a, const vector<T>& r, const vector<T>& f) {
+  int N = r.size();
+  for (int u=0; u<N; u++) {
+    if (a.precision==1) a.cf[u] = float(r[u]*f[u]);
+    if (a.precision==2) a.cb[u] = BFloat16(float(r[u]*f[u]));
+  }
+}
+
+template <class T>
+void pagerankPackedContributionsOmpW(PagerankPacked& a, const vector<T>& r, const vector<T>& f) {
+  int N = r.size();
+  #pragma omp parallel for schedule(static, 2048)
+  for (int u=0; u<N; u++) {
+    if (a.precision==1) a.cf[u] = float(r[u]*f[u]);
+    if (a.precision==2) a.cb[u] = BFloat16(float(r[u]*f[u]));
+  }
+}
+
+
+// Update CSR in place, after in-edges of vertices (vs) or out-degree of
+// vertices (us) have changed in transpose graph. Vertex set must be unchanged.
+// Only rows of changed vertices are read from the graph. Rows in between are
+// shifted by the change in size of the changed rows before them (if any), so
+// rows before the first changed row, and rows whose degree is unchanged, are
+// left alone, and no memory is allocated unless efrom grows past its capacity.
+template <class T, class H, class J, class I>
+bool pagerankCsrUpdateOmpU(PagerankCsr<T, I>& a, const H& xt, const J& vs, const J& us) {
+  int S = a.span(), N = a.order();
+  if (xt.span()!=S || xt.order()!=N) return false;
+  vector<int> is;
+  for (auto v : vs) {
+    int i = v<S? a.ids[v] : -1;
+    if (i<0) return false;
+    is.push_back(i);
+  }
+  sort(is.begin(), is.end());
+  is.erase(unique(is.begin(), is.end()), is.end());
+  // Find shift (ds[k]) of rows after each changed row (is[k]).
+  int    K = is.size();
+  size_t M = a.vfrom[N];
+  vector<ptrdiff_t> ds(K);
+  ptrdiff_t d = 0;
+  for (int k=0; k<K; k++) {
+    int i = is[k];
+    d += ptrdiff_t(xt.degree(a.ks[i])) - ptrdiff_t(a.vfrom[i+1] - a.vfrom[i]);
+    ds[k] = d;
+  }
+  // Move rows between changed rows, so that no row is overwritten before it
+  // is moved: those moving left from the front, those moving right from the back.
+  auto fm = [&](int k) {
+    auto ib = a.efrom.begin() + a.vfrom[is[k]+1];
+    auto ie = a.efrom.begin() + (k+1<K? a.vfrom[is[k+1]] : M);
+    if (ds[k]<0) copy(ib, ie, ib + ds[k]);
+    else copy_backward(ib, ie, ie + ds[k]);
+  };
+  if (d>0) a.efrom.resize(M + d);
+  for (int k=0; k<K; k++)
+    if (ds[k]<0) fm(k);
+  for (int k=K-1; k>=0; k--)
+    if (ds[k]>0) fm(k);
+  if (d<0) a.efrom.resize(M + d);
+  // Shift offsets of rows after each changed row.
+  if (any_of(ds.begin(), ds.end(), [](auto d) { return d!=0; })) {
+    const int B = 2048;
+    #pragma omp parallel for schedule(static, 1)
+    for (int b=is[0]+1; b<=N; b+=B) {
+      int k = int(upper_bound(is.begin(), is.end(), b-1) - is.begin()) - 1;
+      for (int i=b; i<min(b+B, N+1); i++) {
+        while (k+1<K && is[k+1]<i) ++k;
+        a.vfrom[i] += ds[k];
+      }
+    }
+  }
+  // Rewrite changed rows from the graph.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int k=0; k<K; k++) {
+    size_t j = a.vfrom[is[k]];
+    xt.forEachEdgeKey(a.ks[is[k]], [&](auto v) { a.efrom[j++] = a.ids[v]; });
+  }
+  for (auto u : us) {
+    int i = u<S? a.ids[u] : -1;
+    if (i>=0) a.vdata[i] = xt.vertexValue(u);
+  }
+  a.cfrom.clear();  // components may have changed
+  a.packed = PagerankPacked();
+  a.placed.clear();
+  return true;
+}
+
+
+
+
+// PAGERANK-CSR-FILE
+// -----------------
+// Load CSR directly from an MTX file, or from a binary cache of it.
+
+// Read transpose of graph (keys 1..n, self-loop on each vertex) from MTX file.
+template <class T, class I>
+bool readMtxPagerankCsrOmpW(PagerankCsr<T, I>& a, const char *pth) {
+  if (!readMtxTransposeCsrOmpW(a.vfrom, a.efrom, a.vdata, pth, true)) return false;
+  int N = a.vdata.size();
+  a.ks.resize(N);
+  a.ids.resize(N+1);
+  a.ids[0] = -1;
+  a.cfrom.clear();
+  #pragma omp parallel for schedule(static, 2048)
+  for (int i=0; i<N; i++) {
+    a.ks[i]    = i+1;
+    a.ids[i+1] = i;
+  }
+  a.a.resize(N); a.r.resize(N); a.c.resize(N); a.f.resize(N); a.q.resize(N);
+  a.packed = PagerankPacked();
+  a.placed.clear();
+  return true;
+}
+
+
+#define PAGERANK_CSR_MAGIC 0x3252534352474150ULL  // "PAGRCSR2"
+
+// Layout: magic, span, order, size, components+1 (int64), then
+// ks (int32), vfrom (int64), efrom, vdata, cfrom (int32) arrays.
+template <class T, class I>
+bool writePagerankCsr(const char *pth, const PagerankCsr<T, I>& x) {
+  ofstream f(pth, std::ios::binary);
+  if (!f) return false;
+  uint64_t m = PAGERANK_CSR_MAGIC;
+  int64_t  h[4] = {x.span(), x.order(), int64_t(x.size()), int64_t(x.cfrom.size())};
+  auto fw = [&](const auto& v) { f.write((const char*) v.data(), v.size() * sizeof(v[0])); };
+  vector<int64_t> vfrom(x.vfrom.begin(), x.vfrom.end());
+  f.write((const char*) &m, sizeof(m));
+  f.write((const char*) h,  sizeof(h));
+  fw(x.ks); fw(vfrom); fw(x.efrom); fw(x.vdata); fw(x.cfrom);
+  return bool(f);
+}
+
+
+// Check that offsets, in-edges, and keys (span S) of a CSR read from a
+// cache are in bounds, so that a stale or damaged file is rejected here,
+// instead of causing out-of-bounds accesses in the solver.
+template <class T, class I>
+bool pagerankCsrValidOmp(const PagerankCsr<T, I>& a, size_t S) {
+  size_t N = a.ks.size(), M = a.efrom.size(), C = a.cfrom.size();
+  if (a.vfrom[0]!=0 || size_t(a.vfrom[N])!=M) return false;
+  bool ok = true;
+  #pragma omp parallel for schedule(static, 2048) reduction(&&:ok)
+  for (size_t i=0; i<N; i++)
+    ok = ok && a.vfrom[i]<=a.vfrom[i+1] && a.ks[i]>=0 && size_t(a.ks[i])<S && a.vdata[i]>=0;
+  #pragma omp parallel for schedule(static, 2048) reduction(&&:ok)
+  for (size_t j=0; j<M; j++)
+    ok = ok && a.efrom[j]>=0 && size_t(a.efrom[j])<N;
+  for (size_t k=0; k<C; k++)
+    ok = ok && a.cfrom[k]>=0 && size_t(a.cfrom[k])<=N && (k==0 || a.cfrom[k-1]<=a.cfrom[k]);
+  if (!ok) return false;
+  // Keys must be distinct, for ids to be the inverse of ks.
+  vector<bool> seen(S);
+  for (size_t i=0; i<N; i++) {
+    if (seen[a.ks[i]]) return false;
+    seen[a.ks[i]] = true;
+  }
+  return true;
+}
+
+
+template <class T, class I>
+bool readPagerankCsrOmpW(PagerankCsr<T, I>& a, const char *pth) {
+  MappedFile f(pth);
+  const size_t H = sizeof(uint64_t) + 4 * sizeof(int64_t);
+  if (f.size()<H) return false;
+  uint64_t m; int64_t h[4];
+  memcpy(&m, f.data(), sizeof(m));
+  memcpy(h,  f.data() + sizeof(m), sizeof(h));
+  if (m!=PAGERANK_CSR_MAGIC) return false;
+  for (int k=0; k<4; ++k)
+    if (h[k]<0 || size_t(h[k])>f.size()) return false;
+  size_t S = h[0], N = h[1], M = h[2], C = h[3];
+  if (N>S || f.size() != H + (N*2 + M + C) * sizeof(int) + (N+1) * sizeof(int64_t)) return false;
+  if (M > size_t(numeric_limits<I>::max())) return false;  // offsets too narrow
+  const char *p = f.data() + H;
+  auto fr = [&](auto& v, size_t n, auto s) {
+    using V = decltype(s);  // stored type
+    v.resize(n); copyValuesOmpW(v.data(), (const V*) p, n); p += n * sizeof(V);
+  };
+  fr(a.ks, N, int()); fr(a.vfrom, N+1, int64_t()); fr(a.efrom, M, int()); fr(a.vdata, N, int()); fr(a.cfrom, C, int());
+  if (!pagerankCsrValidOmp(a, S)) { a = PagerankCsr<T, I>(); return false; }
+  a.ids.assign(S, -1);
+  #pragma omp parallel for schedule(static, 2048)
+  for (int i=0; i<int(N); i++)
+    a.ids[a.ks[i]] = i;
+  a.a.resize(N); a.r.resize(N); a.c.resize(N); a.f.resize(N); a.q.resize(N);
+  a.packed = PagerankPacked();
+  a.placed.clear();
+  return true;
+}
@@ -1,5 +1,10 @@
 #pragma once
+#include <utility>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <numeric>
 #include <algorithm>
 #include "_main.hxx"
 #include "transpose.hxx"
@@ -9,9 +14,277 @@
 #include "pagerankOmp.hxx"
 #include "pagerankMonolithicSeq.hxx"
 
+using std::pair;
 using std::vector;
+using std::atomic;
+using std::memory_order_relaxed;
+using std::numeric_limits;
 using std::swap;
 using std::min;
+using std::max;
+using std::abs;
+using std::lower_bound;
+using std::upper_bound;
+using std::iota;
+using std::sqrt;
+
+
+
+
+// PAGERANK-PARTITION
+// ------------------
+// For dividing vertices among threads (boundaries of each range).
+
+inline vector<int> pagerankPartitionByVertices(int i, int n, int TS) {
+  vector<int> a(TS+1);
+  int DN = ceilDiv(n, TS);
+  for (int t=0; t<=TS; t++)
+    a[t] = min(i + t*DN, i + n);
+  return a;
+}
+
+// Each vertex weighs its in-degree + 1, so that vertices without
+// in-edges still get spread out (vfrom[v]+v is a prefix sum of weights).
+template <class I>
+inline vector<int> pagerankPartitionByEdges(const vector<I>& vfrom, int i, int n, int TS) {
+  vector<int> a(TS+1);
+  size_t W0 = size_t(vfrom[i]) + i;
+  size_t W  = size_t(vfrom[i+n]) + (i+n) - W0;
+  a[0] = i; a[TS] = i+n;
+  for (int t=1; t<TS; t++) {
+    size_t w = W0 + W*t/TS;
+    int lo = a[t-1], hi = i+n;
+    while (lo<hi) {
+      int m = lo + (hi-lo)/2;
+      if (size_t(vfrom[m]) + m < w) lo = m+1;
+      else hi = m;
+    }
+    a[t] = lo;
+  }
+  return a;
+}
+
+// Move each cut to the nearest component boundary, if it is close enough, so
+// that fewer in-edges cross threads (and read ranks of another thread).
+inline void pagerankPartitionSnapU(vector<int>& ps, const vector<int>& cfrom) {
+  int TS = ps.size()-1;
+  if (cfrom.empty() || TS<2) return;
+  vector<int> qs = ps;
+  for (int t=1; t<TS; t++) {
+    int  w  = (qs[t+1] - qs[t-1]) / 4, b = qs[t];
+    auto it = lower_bound(cfrom.begin(), cfrom.end(), qs[t]);
+    if (it!=cfrom.end()) b = *it;
+    if (it!=cfrom.begin() && (it==cfrom.end() || qs[t] - *(it-1) < b - qs[t])) b = *(it-1);
+    if (abs(b - qs[t]) <= w) ps[t] = b;
+    ps[t] = min(max(ps[t], ps[t-1]), ps[TS]);
+  }
+}
+
+template <class I>
+inline vector<int> pagerankPartition(const vector<I>& vfrom, const vector<int>& cfrom, int i, int n, int TS, int PM) {
+  auto a = PM==1? pagerankPartitionByEdges(vfrom, i, n, TS) : pagerankPartitionByVertices(i, n, TS);
+  pagerankPartitionSnapU(a, cfrom);
+  return a;
+}
+
+// Divide a list of vertices (vs) among threads (boundaries in the list).
+template <class I>
+inline vector<int> pagerankPartitionAt(const vector<I>& vfrom, const vector<int>& vs, int TS, int PM) {
+  int n = vs.size();
+  if (PM!=1) return pagerankPartitionByVertices(0, n, TS);
+  vector<size_t> ws(n+1);
+  for (int j=0; j<n; j++)
+    ws[j+1] = ws[j] + vfrom[vs[j]+1] - vfrom[vs[j]];
+  return pagerankPartitionByEdges(ws, 0, n, TS);
+}
+
+
+
+
+// PAGERANK-ERROR-COMBINE
+// ----------------------
+// For merging errors of disjoint vertex sets.
+
+template <class T>
+inline T pagerankErrorCombine(T x, T y, int EF) {
+  switch (EF) {
+    case 1:  return x + y;
+    case 2:  return sqrt(x*x + y*y);
+    default: return max(x, y);
+  }
+}
+
+template <class T>
+void pagerankErrorCombineAtomic(atomic<T>& a, T y, int EF) {
+  T x = a.load();
+  while (!a.compare_exchange_weak(x, pagerankErrorCombine(x, y, EF)));
+}
+
+
+
+
+// PAGERANK-CONVERGENCE
+// --------------------
+// For detecting convergence from errors of all threads, without a barrier.
+// Each thread publishes error of its range after every sweep, along with its
+// sweep number (epoch). A thread that sees the combined error below tolerance
+// remembers the epochs of all threads, and signals all threads to stop only if
+// the combined error is still below tolerance after every thread has completed
+// another sweep (so that no stale error is trusted).
+
+template <class T>
+struct alignas(64) PagerankConvergenceSlot {
+  atomic<T>    error;  // error of range in latest sweep
+  atomic<int>  epoch;  // number of sweeps completed
+  atomic<bool> done;   // no more sweeps (limit reached)
+};
+
+
+template <class T>
+struct PagerankConvergence {
+  vector<PagerankConvergenceSlot<T>> slots;
+  atomic<bool> stop;
+  T   E;
+  int EF;
+
+  PagerankConvergence(int TS, T E, int EF) :
+  slots(TS), E(E), EF(EF) {
+    for (auto& s : slots) {
+      s.error = numeric_limits<T>::infinity();
+      s.epoch = 0;
+      s.done  = false;
+    }
+    stop = false;
+  }
+
+
+  inline bool stopped() const {
+    return stop.load(memory_order_relaxed);
+  }
+
+  // Thread (t) has no more sweeps to perform.
+  inline void finish(int t, T el=T()) {
+    slots[t].error = el;
+    slots[t].done  = true;
+  }
+
+  // Publish error (el) of sweep (l) of thread (t), and check if all threads should stop.
+  // Thread-local epochs seen at first observation of convergence are kept in (seen).
+  bool update(int t, T el, int l, vector<int>& seen) {
+    slots[t].error = el;
+    slots[t].epoch = l;
+    if (stopped()) return true;
+    int TS = slots.size(); T g = T();
+    for (int u=0; u<TS; u++)
+      g = pagerankErrorCombine(g, slots[u].error.load(), EF);
+    if (!(g<E)) { seen.clear(); return false; }
+    if (seen.empty()) {
+      for (int u=0; u<TS; u++)
+        seen.push_back(slots[u].epoch.load());
+      return false;
+    }
+    for (int u=0; u<TS; u++)
+      if (!slots[u].done.load() && slots[u].epoch.load() <= seen[u]) return false;
+    stop = true;
+    return true;
+  }
+};
+
+
+
+
+// PAGERANK-NUMA
+// -------------
+// Place range [ps[t], ps[t+1]) of the CSR and rank vectors on the node of
+// thread (t), which is expected to be pinned. As pinned threads of a node
+// have consecutive ids, each node then holds one contiguous range, balanced
+// by the partition (by in-edges, if asked). Placement is recorded in the
+// CSR, and skipped when the same ranges are already placed.
+
+template <class T, class I>
+void pagerankNumaPlaceOmpU(PagerankCsr<T, I>& x, const vector<int>& ps) {
+  int TS = ps.size()-1;
+  if (x.placed==ps) return;
+  x.placed = ps;
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; t++) {
+    size_t i = ps[t], n = ps[t+1] - ps[t];
+    size_t j = x.vfrom[i], m = x.vfrom[i+n] - j;
+    firstTouchU(x.vfrom, i, n+1);
+    firstTouchU(x.efrom, j, m);
+    firstTouchU(x.vdata, i, n);
+    firstTouchU(x.a, i, n);
+    firstTouchU(x.r, i, n);
+    firstTouchU(x.c, i, n);
+    firstTouchU(x.f, i, n);
+    firstTouchU(x.q, i, n);
+  }
+}
+
+
+
+
+// PAGERANK-PROFILE
+// ----------------
+// For recording each sweep of each thread, when enabled. The stale-read
+// distance of a sweep is the no. of sweeps completed by the thread, minus
+// those completed by the owner of each in-edge source in another thread's
+// range (sampled at end of sweep), averaged over such in-edges. Reads from
+// an owner that is ahead are not stale, and count as 0.
+
+struct alignas(64) PagerankProfileSlot {
+  atomic<int> epoch;                   // sweeps completed by thread
+  vector<PagerankSweepResult> sweeps;  // sweeps recorded by thread
+};
+
+
+struct PagerankProfile {
+  bool enabled;
+  vector<PagerankProfileSlot> slots;
+  vector<vector<size_t>> cross;  // no. of in-edges of range of thread (t), from range of thread (u)
+  decltype(timeNow()) t0;
+
+  template <class I>
+  PagerankProfile(bool enabled, const vector<I>& vfrom, const vector<int>& efrom, const vector<int>& ps) :
+  enabled(enabled), t0(timeNow()) {
+    if (!enabled) return;
+    int TS = ps.size()-1;
+    slots  = vector<PagerankProfileSlot>(TS);
+    cross.assign(TS, vector<size_t>(TS));
+    for (auto& s : slots) s.epoch = 0;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t=0; t<TS; t++) {
+      for (I j=vfrom[ps[t]]; j<vfrom[ps[t+1]]; ++j) {
+        int u = int(upper_bound(ps.begin(), ps.end(), efrom[j]) - ps.begin()) - 1;
+        ++cross[t][u];
+      }
+    }
+    t0 = timeNow();
+  }
+
+
+  // Record sweep (l) of thread (t).
+  inline void record(int t, int l, float duration, size_t edges, double error, float idle) {
+    if (!enabled) return;
+    int TS = slots.size(); double s = 0, w = 0;
+    slots[t].epoch = l;
+    for (int u=0; u<TS; u++) {
+      if (u==t || cross[t][u]==0) continue;
+      s += double(cross[t][u]) * max(l - slots[u].epoch.load(memory_order_relaxed), 0);
+      w += double(cross[t][u]);
+    }
+    float te = durationMilliseconds(t0, timeNow());
+    slots[t].sweeps.push_back({t, l, te, duration, edges, error, float(w>0? s/w : 0), idle});
+  }
+
+  // Get all recorded sweeps, by thread.
+  inline vector<PagerankSweepResult> sweeps() const {
+    vector<PagerankSweepResult> a;
+    for (const auto& s : slots)
+      a.insert(a.end(), s.sweeps.begin(), s.sweeps.end());
+    return a;
+  }
+};
 
 
 
@@ -19,20 +292,185 @@ using std::min;
 // PAGERANK-LOOP
 // -------------
 
-template <bool O, bool D, class T>
-int pagerankBarrierfreeOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<int>& vfrom, const vector<int>& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF) {
-  float l = 0;
+#define PAGERANK_STEAL_CHUNK 2048
+
+// Sweep range [i, i+n) of thread (t) until converged (or all threads have, with GC).
+template <bool O, bool D, class T, class J, class I>
+int pagerankBarrierfreeSeqLoopU(vector<T>& a, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, J& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF, bool GC, int t, PagerankConvergence<T>& cv, PagerankProfile& pf) {
+  int l = 0; T el = T(); vector<int> seen;
+  size_t m = vfrom[i+n] - vfrom[i];
+  while (O && l<L && !cv.stopped()) {
+    auto t1 = timeNow();
+    T c0 = D? pagerankTeleport(r, vdata, N, p) : (1-p)/N;
+    pagerankCalculateOrderedU(a, r, f, vfrom, efrom, i, n, c0);  // update ranks of vertices
+    el = pagerankError(a, i, n, EF); ++l;                        // compare previous and current ranks
+    pf.record(t, l, durationMilliseconds(t1, timeNow()), m, el, 0);
+    if (GC? cv.update(t, el, l, seen) : el<E) break;             // check tolerance (of all threads)
+  }
+  if (l>=L) cv.finish(t, el);
+  return l;
+}
+
+// Shared state of a thread's range, for work stealing.
+template <class T>
+struct alignas(64) PagerankStealState {
+  atomic<int>  next;      // next chunk to process in current sweep
+  atomic<int>  done;      // chunks processed in current sweep
+  atomic<T>    error;     // error of chunks processed in current sweep
+  atomic<bool> finished;  // owner has converged (no more sweeps)
+  T c0;                   // teleport contribution of current sweep
+};
+
+
+template <bool O, bool D, class T, class J, class I>
+int pagerankBarrierfreeOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<I>& vfrom, J& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF, bool GC, const vector<int>& ps, vector<PagerankThreadResult>& ts, PagerankProfile& pf) {
   if (!O) return 0;
   // Ordered approach
-  int TS = omp_get_max_threads();
-  int DN = ceilDiv(n, TS);
+  int TS = ps.size()-1;
+  PagerankConvergence<T> cv(TS, E, EF);
+  for (int t=0; t<TS; t++)
+    if (ps[t+1]==ps[t]) cv.finish(t);
+  ts.assign(TS, PagerankThreadResult());
+  auto t0 = timeNow();
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; t++) {
+    int ti = ps[t], tn = ps[t+1] - ps[t], tl = 0;
+    float tt = measureDuration([&]() {
+      if (tn>0) tl = pagerankBarrierfreeSeqLoopU<O, D, T>(a, r, f, vfrom, efrom, vdata, ti, tn, N, p, E, L, EF, GC, t, cv, pf);
+    });
+    ts[t] = {ti, ti+tn, tl, 0, tt, 0};
+  }
+  float tw = durationMilliseconds(t0, timeNow());
+  float l  = 0;
+  for (auto& s : ts) {
+    s.idle = tw - s.time;
+    l += float(s.iterations) * (s.end - s.begin)/n;
+  }
+  return int(l + 0.5f);
+}
+
+
+// Threads that have converged take chunks from the ranges of others.
+template <bool O, bool D, class T, class J, class I>
+int pagerankBarrierfreeStealOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<I>& vfrom, J& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF, bool GC, const vector<int>& ps, const vector<int>& nd, vector<PagerankThreadResult>& ts, PagerankProfile& pf) {
+  const int CN = PAGERANK_STEAL_CHUNK;
+  if (!O) return 0;
+  // Ordered approach
+  int TS = ps.size()-1;
+  vector<PagerankStealState<T>> ss(TS);
+  PagerankConvergence<T> cv(TS, E, EF);
+  for (int t=0; t<TS; t++) {
+    if (ps[t+1]==ps[t]) cv.finish(t);
+    ss[t].next = ss[t].done = 0;
+    ss[t].error    = T();
+    ss[t].finished = ps[t+1]==ps[t];
+  }
+  ts.assign(TS, PagerankThreadResult());
+  auto t0 = timeNow();
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<TS; t++) {
+    auto& s  = ss[t];
+    int   ti = ps[t], tn = ps[t+1] - ps[t], l = 0, k = 0;
+    int   tc = ceilDiv(tn, CN), steals = 0;
+    float tt = 0;
+    size_t tm = 0;
+    vector<int> seen;
+    // Process a chunk (k) of range of thread (u).
+    auto fc = [&](int u, int k) {
+      auto& su = ss[u];
+      int ci = ps[u] + k*CN;
+      int cn = min(ci + CN, ps[u+1]) - ci;
+      tm += vfrom[ci+cn] - vfrom[ci];
+      tt += measureDuration([&]() {
+        pagerankCalculateOrderedU(a, r, f, vfrom, efrom, ci, cn, su.c0);
+        pagerankErrorCombineAtomic(su.error, pagerankError(a, ci, cn, EF), EF);
+      });
+      su.done.fetch_add(1);
+    };
+    // Sweep own range, until converged.
+    while (tn>0 && l<L && !cv.stopped()) {
+      auto t1 = timeNow();
+      s.c0 = D? pagerankTeleport(r, vdata, N, p) : (1-p)/N;
+      s.error = T();
+      s.done  = 0;
+      s.next  = 0;
+      tm = 0;
+      while ((k = s.next.fetch_add(1)) < tc) fc(t, k);
+      auto t2 = timeNow();
+      while (s.done.load() < tc) std::this_thread::yield();
+      auto t3 = timeNow();
+      ++l;
+      pf.record(t, l, durationMilliseconds(t1, t3), tm, s.error.load(), durationMilliseconds(t2, t3));
+      if (GC? cv.update(t, s.error.load(), l, seen) : s.error.load() < E) break;
+    }
+    if (l>=L) cv.finish(t, s.error.load());
+    s.finished = true;
+    // Help others (on the same node, if given), until all have converged.
+    for (bool busy=true; busy;) {
+      bool stole = false; busy = false;
+      for (int d=1; d<TS; d++) {
+        int u = (t+d) % TS, uc = ceilDiv(ps[u+1] - ps[u], CN);
+        if (!nd.empty() && nd[u]!=nd[t]) continue;
+        if (ss[u].finished.load()) continue;
+        busy = true;
+        if (ss[u].next.load() >= uc) continue;
+        if ((k = ss[u].next.fetch_add(1)) < uc) { fc(u, k); ++steals; stole = true; }
+      }
+      if (!stole) std::this_thread::yield();
+    }
+    ts[t] = {ti, ti+tn, l, steals, tt, 0};
+  }
+  float tw = durationMilliseconds(t0, timeNow());
+  float l  = 0;
+  for (auto& s : ts) {
+    s.idle = tw - s.time;
+    l += float(s.iterations) * (s.end - s.begin)/n;
+  }
+  return int(l + 0.5f);
+}
+
+
+
+
+// Sweep listed vertices vs[i, i+n) of thread (t), until converged.
+template <bool O, bool D, class T, class I>
+int pagerankBarrierfreeAtSeqLoopU(vector<T>& a, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, const vector<int>& efrom, const vector<int>& vdata, const vector<int>& vs, int i, int n, int N, T p, T E, int L, int EF, bool GC, int t, PagerankConvergence<T>& cv) {
+  int l = 0; T el = T(); vector<int> seen;
+  while (O && l<L && !cv.stopped()) {
+    T c0 = D? pagerankTeleport(r, vdata, N, p) : (1-p)/N;
+    pagerankCalculateOrderedAtU(a, r, f, vfrom, efrom, vs, i, n, c0);  // update ranks of listed vertices
+    el = pagerankError(a, i, n, EF); ++l;                               // compare previous and current ranks
+    if (GC? cv.update(t, el, l, seen) : el<E) break;                    // check tolerance
+  }
+  if (l>=L) cv.finish(t, el);
+  return l;
+}
+
+
+// Threads sweep only listed vertices (vs) in their range of the list.
+template <bool O, bool D, class T, class I>
+int pagerankBarrierfreeAtOmpLoopU(vector<T>& a, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, const vector<int>& efrom, const vector<int>& vdata, const vector<int>& vs, int N, T p, T E, int L, int EF, bool GC, const vector<int>& ps, vector<PagerankThreadResult>& ts) {
+  if (!O) return 0;
+  // Ordered approach
+  int TS = ps.size()-1, n = vs.size();
+  PagerankConvergence<T> cv(TS, E, EF);
+  for (int t=0; t<TS; t++)
+    if (ps[t+1]==ps[t]) cv.finish(t);
+  ts.assign(TS, PagerankThreadResult());
+  auto t0 = timeNow();
   #pragma omp parallel for schedule(static, 1)
   for (int t=0; t<TS; t++) {
-    int ti = i + t*DN;
-    int tI = min(ti + DN, i + n);
-    int tn = tI - ti;
-    int tl = pagerankMonolithicSeqLoopU<O, D, T>(a, r, c, f, vfrom, efrom, vdata, ti, tn, N, p, E, L, EF);
-    l += tl * tn/n;
+    int ti = ps[t], tn = ps[t+1] - ps[t], tl = 0;
+    float tt = measureDuration([&]() {
+      if (tn>0) tl = pagerankBarrierfreeAtSeqLoopU<O, D, T>(a, r, f, vfrom, efrom, vdata, vs, ti, tn, N, p, E, L, EF, GC, t, cv);
+    });
+    ts[t] = {ti, ti+tn, tl, 0, tt, 0};
+  }
+  float tw = durationMilliseconds(t0, timeNow());
+  float l  = 0;
+  for (auto& s : ts) {
+    s.idle = tw - s.time;
+    l += float(s.iterations) * (s.end - s.begin)/n;
   }
   return int(l + 0.5f);
 }
@@ -40,9 +478,70 @@ int pagerankBarrierfreeOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const
 
 
 
+// PAGERANK-FRONTIER
+// -----------------
+// For vertices whose ranks may change after a batch update.
+
+// Find vertices reachable from those with in-edges changed (vs), or from
+// out-neighbours of those with out-degree changed (us), as CSR indices.
+// @returns whether a dead end is affected (then all vertices are)
+template <class T, class G, class J, class I>
+bool pagerankFrontierW(vector<int>& a, const PagerankCsr<T, I>& x, const G& y, const J& vs, const J& us) {
+  int  N = x.order(); bool de = false;
+  vector<char> vis(N);
+  vector<int>  us1;
+  auto fm = [&](auto v) {
+    int i = x.ids[v];
+    if (!vis[i]) { vis[i] = 1; us1.push_back(int(v)); }
+  };
+  for (auto v : vs) fm(v);
+  for (auto u : us) y.forEachEdgeKey(u, fm);
+  while (!us1.empty()) {
+    int u = us1.back(); us1.pop_back();
+    if (x.vdata[x.ids[u]]==0) de = true;
+    y.forEachEdgeKey(u, fm);
+  }
+  a.clear();
+  for (int i=0; i<N; i++)
+    if (de || vis[i]) a.push_back(i);
+  return de;
+}
+
+
+
+
 // PAGERANK (STATIC / INCREMENTAL)
 // -------------------------------
 
+template <bool O, bool D, class T, class I>
+PagerankResult<T> pagerankBarrierfreeOmpInt(PagerankCsr<T, I>& x, int i, int n, const vector<T> *q, const PagerankOptions<T>& o) {
+  int TS = omp_get_max_threads();
+  vector<PagerankThreadResult> ts;
+  vector<PagerankSweepResult>  sw;
+  auto ps = pagerankPartition(x.vfrom, x.cfrom, i, n, TS, o.partition);
+  NumaTopology tp; vector<int> nd;
+  float tn = !o.numa? 0 : measureDuration([&]() {
+    tp = numaTopology();
+    nd = pinThreadsOmp(tp);
+    pagerankNumaPlaceOmpU(x, ps);
+  });
+  auto fl = [&](auto& a, auto& r, auto& c, const auto& f, const auto& vfrom, auto& efrom, const auto& vdata, int i, int n, int N, T p, T E, int L, int EF) {
+    PagerankProfile pf(o.profile, x.vfrom, x.efrom, ps);
+    int l = o.steal?
+      pagerankBarrierfreeStealOmpLoopU<O, D, T>(a, r, c, f, vfrom, efrom, vdata, i, n, N, p, E, L, EF, o.global, ps, nd, ts, pf) :
+      pagerankBarrierfreeOmpLoopU<O, D, T>(a, r, c, f, vfrom, efrom, vdata, i, n, N, p, E, L, EF, o.global, ps, ts, pf);
+    sw = pf.sweeps();
+    return l;
+  };
+  auto a = pagerankOmp(x, i, n, fl, q, o);
+  if (o.numa) unpinThreadsOmp(tp);
+  a.time   += tn;  // include pinning, placement (once per CSR)
+  a.threads = move(ts);
+  a.sweeps  = move(sw);
+  return a;
+}
+
+
 // Find pagerank using multiple threads (pull, CSR).
 // @param x  original graph
 // @param xt transpose graph (with vertex-data=out-degree)
@@ -52,8 +551,18 @@ int pagerankBarrierfreeOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const
 template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankBarrierfreeOmp(const G& x, const H& xt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N  = xt.order();  if (N==0) return PagerankResult<T>::initial(xt, q);
-  auto ks = vertexKeys(xt);
-  return pagerankOmp(xt, ks, 0, N, pagerankBarrierfreeOmpLoopU<O, D, T>, q, o);
+  auto ko = pagerankOrder(x, xt, o.reorder);  // {keys, component starts}
+  return pagerankCsrOmpDo<T>(xt, ko.first, [&](auto& xc) {
+    xc.cfrom.assign(ko.second.begin(), ko.second.end());
+    return pagerankBarrierfreeOmpInt<O, D>(xc, 0, N, q, o);
+  });
+}
+
+// Find pagerank on a prebuilt CSR, reusing its buffers.
+template <bool O, bool D, class T, class I>
+PagerankResult<T> pagerankBarrierfreeOmp(PagerankCsr<T, I>& x, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
+  int  N = x.order();  if (N==0) return PagerankResult<T>::initial(x, q);
+  return pagerankBarrierfreeOmpInt<O, D>(x, 0, N, q, o);
 }
 
 template <bool O, bool D, class G, class T=float>
@@ -71,8 +580,8 @@ PagerankResult<T> pagerankBarrierfreeOmp(const G& x, const vector<T> *q=nullptr,
 template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankBarrierfreeOmpDynamic(const G& x, const H& xt, const G& y, const H& yt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N = yt.order();                             if (N==0) return PagerankResult<T>::initial(yt, q);
-  auto [ks, n] = dynamicInVertices(x, xt, y, yt);  if (n==0) return PagerankResult<T>::initial(yt, q);
-  return pagerankOmp(yt, ks, 0, n, pagerankBarrierfreeOmpLoopU<O, D, T>, q, o);
+  auto kn = dynamicInVertices(x, xt, y, yt);  int n = kn.second;  if (n==0) return PagerankResult<T>::initial(yt, q);
+  return pagerankCsrOmpDo<T>(yt, kn.first, [&](auto& yc) { return pagerankBarrierfreeOmpInt<O, D>(yc, 0, n, q, o); });
 }
 
 template <bool O, bool D, class G, class T=float>
@@ -81,3 +590,68 @@ PagerankResult<T> pagerankBarrierfreeOmpDynamic(const G& x, const G& y, const ve
   auto yt = transposeWithDegree(y);
   return pagerankBarrierfreeOmpDynamic<O, D>(x, xt, y, yt, q, o);
 }
+
+
+
+
+// PAGERANK (BATCH)
+// ----------------
+
+// Update pagerank after a batch of edge deletions and insertions, in place.
+// Graph (y, yt) and its CSR (x) are updated incrementally, and only vertices
+// reachable from changed vertices are swept, from the previous ranks (x.r).
+// The CSR is updated in place: only changed rows are read from the graph,
+// and rows in between are shifted (if their position changes).
+// @param x   CSR of yt, with ranks of last computation (updated)
+// @param y   original graph (updated)
+// @param yt  transpose graph, with vertex-data=out-degree (updated)
+// @param del edges to delete
+// @param ins edges to insert
+// @param o   options {damping=0.85, tolerance=1e-6, maxIterations=500}
+// @returns {ranks, iterations, time (inc. graph, CSR update)}
+template <bool O, bool D, class G, class H, class K, class T, class I>
+PagerankResult<T> pagerankBarrierfreeOmpBatchU(PagerankCsr<T, I>& x, G& y, H& yt, const vector<pair<K, K>>& del, const vector<pair<K, K>>& ins, const PagerankOptions<T>& o={}) {
+  int TS = omp_get_max_threads();
+  T   p  = o.damping;
+  T   E  = o.tolerance;
+  int L  = o.maxIterations, l = 0;
+  int EF = o.toleranceNorm;
+  vector<int> fs;
+  vector<PagerankThreadResult> ts;
+  float t = measureDuration([&]() {
+    auto [vs, us] = applyEdgeBatchU(y, yt, del, ins);
+    bool de = false;  // did a vertex become, or cease to be, a dead end?
+    auto fd = [&]() {
+      for (auto u : us) {
+        int i = u<x.span()? x.ids[u] : -1;
+        if (i>=0 && x.vdata[i]==0) de = true;
+      }
+    };
+    fd();  // with old out-degrees
+    if (pagerankCsrUpdateOmpU(x, yt, vs, us)) fd();  // with new out-degrees
+    else {
+      // Vertices were added, so rebuild CSR (new vertices start at 1/N).
+      vector<T> q(x.span());
+      scatterValuesOmpW(q, x.r, x.ks);
+      int S = x.span();
+      pagerankCsrOmpW(x, yt, yt.vertexKeys());
+      for (int i=0, N=x.order(); i<N; i++)
+        x.r[i] = x.ks[i]<S && q[x.ks[i]]>0? q[x.ks[i]] : T(1)/N;
+      de = true;
+    }
+    int N = x.order();
+    if (!pagerankFrontierW(fs, x, y, vs, us) && de) {
+      fs.resize(N);
+      iota(fs.begin(), fs.end(), 0);
+    }
+    pagerankFactorOmpW(x.f, x.vdata, 0, N, p);
+    if (fs.empty()) return;
+    auto ps = pagerankPartitionAt(x.vfrom, fs, TS, o.partition);
+    l = pagerankBarrierfreeAtOmpLoopU<O, D, T>(x.a, x.r, x.f, x.vfrom, x.efrom, x.vdata, fs, N, p, E, L, EF, o.global, ps, ts);
+  });
+  vector<T> a(x.span());
+  scatterValuesOmpW(a, x.r, x.ks);
+  PagerankResult<T> b(a, l, t);
+  b.threads = move(ts);
+  return b;
+}
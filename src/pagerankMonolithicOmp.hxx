@@ -17,8 +17,8 @@ using std::swap;
 // PAGERANK-LOOP
 // -------------
 
-template <bool O, bool D, class T>
-int pagerankMonolithicOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<int>& vfrom, const vector<int>& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF) {
+template <bool O, bool D, class T, class J, class I>
+int pagerankMonolithicOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<I>& vfrom, J& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF) {
   int l = 0;
   // Unordered approach
   while (!O && l<L) {
@@ -39,6 +39,12 @@ int pagerankMonolithicOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const v
   return l;
 }
 
+// Loop for plain or compact in-edges.
+template <bool O, bool D, class T>
+inline auto pagerankMonolithicOmpLoop() {
+  return [](auto&&... args) { return pagerankMonolithicOmpLoopU<O, D, T>(args...); };
+}
+
 
 
 
@@ -54,8 +60,15 @@ int pagerankMonolithicOmpLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const v
 template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankMonolithicOmp(const G& x, const H& xt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N  = xt.order();  if (N==0) return PagerankResult<T>::initial(xt, q);
-  auto ks = vertexKeys(xt);
-  return pagerankOmp(xt, ks, 0, N, pagerankMonolithicOmpLoopU<O, D, T>, q, o);
+  auto ks = pagerankOrder(x, xt, o.reorder).first;
+  return pagerankOmp(xt, ks, 0, N, pagerankMonolithicOmpLoop<O, D, T>(), q, o);
+}
+
+// Find pagerank on a prebuilt CSR, reusing its buffers.
+template <bool O, bool D, class T, class I>
+PagerankResult<T> pagerankMonolithicOmp(PagerankCsr<T, I>& x, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
+  int  N = x.order();  if (N==0) return PagerankResult<T>::initial(x, q);
+  return pagerankOmp(x, 0, N, pagerankMonolithicOmpLoop<O, D, T>(), q, o);
 }
 
 template <bool O, bool D, class G, class T=float>
@@ -74,7 +87,7 @@ template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankMonolithicOmpDynamic(const G& x, const H& xt, const G& y, const H& yt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N = yt.order();                             if (N==0) return PagerankResult<T>::initial(yt, q);
   auto [ks, n] = dynamicInVertices(x, xt, y, yt);  if (n==0) return PagerankResult<T>::initial(yt, q);
-  return pagerankOmp(yt, ks, 0, n, pagerankMonolithicOmpLoopU<O, D, T>, q, o);
+  return pagerankOmp(yt, ks, 0, n, pagerankMonolithicOmpLoop<O, D, T>(), q, o);
 }
 
 template <bool O, bool D, class G, class T=float>
@@ -16,8 +16,8 @@ using std::swap;
 // PAGERANK-LOOP
 // -------------
 
-template <bool O, bool D, class T>
-int pagerankMonolithicSeqLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<int>& vfrom, const vector<int>& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF) {
+template <bool O, bool D, class T, class J, class I>
+int pagerankMonolithicSeqLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const vector<T>& f, const vector<I>& vfrom, J& efrom, const vector<int>& vdata, int i, int n, int N, T p, T E, int L, int EF) {
   int l = 0;
   // Unordered approach
   while (!O && l<L) {
@@ -38,6 +38,12 @@ int pagerankMonolithicSeqLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const v
   return l;
 }
 
+// Loop for plain or compact in-edges.
+template <bool O, bool D, class T>
+inline auto pagerankMonolithicSeqLoop() {
+  return [](auto&&... args) { return pagerankMonolithicSeqLoopU<O, D, T>(args...); };
+}
+
 
 
 
@@ -53,8 +59,15 @@ int pagerankMonolithicSeqLoopU(vector<T>& a, vector<T>& r, vector<T>& c, const v
 template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankMonolithicSeq(const G& x, const H& xt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N  = xt.order();  if (N==0) return PagerankResult<T>::initial(xt, q);
-  auto ks = vertexKeys(xt);
-  return pagerankSeq(xt, ks, 0, N, pagerankMonolithicSeqLoopU<O, D, T>, q, o);
+  auto ks = pagerankOrder(x, xt, o.reorder).first;
+  return pagerankSeq(xt, ks, 0, N, pagerankMonolithicSeqLoop<O, D, T>(), q, o);
+}
+
+// Find pagerank on a prebuilt CSR, reusing its buffers.
+template <bool O, bool D, class T, class I>
+PagerankResult<T> pagerankMonolithicSeq(PagerankCsr<T, I>& x, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
+  int  N = x.order();  if (N==0) return PagerankResult<T>::initial(x, q);
+  return pagerankSeq(x, 0, N, pagerankMonolithicSeqLoop<O, D, T>(), q, o);
 }
 
 template <bool O, bool D, class G, class T=float>
@@ -73,7 +86,7 @@ template <bool O, bool D, class G, class H, class T=float>
 PagerankResult<T> pagerankMonolithicSeqDynamic(const G& x, const H& xt, const G& y, const H& yt, const vector<T> *q=nullptr, const PagerankOptions<T>& o={}) {
   int  N = yt.order();                             if (N==0) return PagerankResult<T>::initial(yt, q);
   auto [ks, n] = dynamicInVertices(x, xt, y, yt);  if (n==0) return PagerankResult<T>::initial(yt, q);
-  return pagerankSeq(yt, ks, 0, n, pagerankMonolithicSeqLoopU<O, D, T>, q, o);
+  return pagerankSeq(yt, ks, 0, n, pagerankMonolithicSeqLoop<O, D, T>(), q, o);
 }
 
 template <bool O, bool D, class G, class T=float>
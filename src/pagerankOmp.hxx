@@ -10,6 +10,7 @@
 
 using std::vector;
 using std::swap;
+using std::sort;
 
 
 
@@ -50,29 +51,74 @@ T pagerankTeleportOmp(const vector<T>& r, const vector<int>& vdata, int N, T p)
 
 // PAGERANK-CALCULATE
 // ------------------
-// For rank calculation from in-edges.
+// For rank calculation from in-edges. Hub vertices (in-degree at least
+// PAGERANK_HUB_DEGREE) are skipped by the per-vertex loop, and then have
+// their in-edges gathered by all threads, one hub at a time.
 
-template <class T>
-void pagerankCalculateOmpW(vector<T>& a, const vector<T>& c, const vector<int>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
+#define PAGERANK_HUB_DEGREE 100000
+
+template <class T, class I>
+void pagerankCalculateOmpW(vector<T>& a, const vector<T>& c, const vector<I>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
   if (n<SIZE_MIN_OMPM) { pagerankCalculateW(a, c, vfrom, efrom, i, n, c0); return; }
+  vector<int> hs;
   #pragma omp parallel for schedule(dynamic, 2048)
-  for (int v=i; v<i+n; v++)
-    a[v] = c0 + sumValuesAt(c, sliceIterable(efrom, vfrom[v], vfrom[v+1]));
+  for (int v=i; v<i+n; v++) {
+    size_t d = vfrom[v+1] - vfrom[v];
+    if (d>=PAGERANK_HUB_DEGREE) {
+      #pragma omp critical
+      hs.push_back(v);
+    }
+    else a[v] = sumValuesAtSimd(c.data(), efrom.data()+vfrom[v], d, c0);
+  }
+  for (int v : hs)
+    a[v] = sumValuesAtSimdOmp(c.data(), efrom.data()+vfrom[v], vfrom[v+1]-vfrom[v], c0);
 }
 
-template <class T>
-void pagerankCalculateOrderedOmpU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<int>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
+template <class T, class I>
+void pagerankCalculateOrderedOmpU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
   if (n<SIZE_MIN_OMPM) { pagerankCalculateOrderedU(e, r, f, vfrom, efrom, i, n, c0); return; }
+  vector<int> hs;
   #pragma omp parallel for schedule(dynamic, 2048)
   for (int v=i; v<i+n; v++) {
-    T a = c0;
-    for (int u : sliceIterable(efrom, vfrom[v], vfrom[v+1]))
-      a += f[u] * r[u];
+    size_t d = vfrom[v+1] - vfrom[v];
+    if (d>=PAGERANK_HUB_DEGREE) {
+      #pragma omp critical
+      hs.push_back(v);
+      continue;
+    }
+    T a = sumProductsAtSimd(f.data(), r.data(), efrom.data()+vfrom[v], d, c0);
     e[v] = a - r[v];
     r[v] = a;
   }
+  sort(hs.begin(), hs.end());
+  for (int v : hs) {
+    T a = sumProductsAtSimdOmp(f.data(), r.data(), efrom.data()+vfrom[v], vfrom[v+1]-vfrom[v], c0);
+    e[v] = a - r[v];
+    r[v] = a;
+  }
+}
+
+
+template <class T, class I>
+void pagerankCalculateOmpW(vector<T>& a, const vector<T>& c, const vector<I>& vfrom, const PagerankPacked& efrom, int i, int n, T c0) {
+  if (n<SIZE_MIN_OMPM) { pagerankCalculateW(a, c, vfrom, efrom, i, n, c0); return; }
+  auto fc = [&](int u) -> double { return c[u]; };
+  pagerankPackedDo(efrom, [&](auto C, auto P) {
+    #pragma omp parallel for schedule(dynamic, 2048)
+    for (int v=i; v<i+n; v++)
+      a[v] = T(pagerankPackedSum<decltype(C)::value>(efrom, vfrom, v, c0, fc));
+  });
 }
 
+template <class T, class I>
+void pagerankCalculateOrderedOmpU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, PagerankPacked& efrom, int i, int n, T c0) {
+  if (n<SIZE_MIN_OMPM) { pagerankCalculateOrderedU(e, r, f, vfrom, efrom, i, n, c0); return; }
+  pagerankPackedDo(efrom, [&](auto C, auto P) {
+    #pragma omp parallel for schedule(dynamic, 2048)
+    for (int v=i; v<i+n; v++)
+      pagerankPackedRankU<decltype(C)::value, decltype(P)::value>(e, r, f, vfrom, efrom, v, c0);
+  });
+}
 
 
 
@@ -83,18 +129,18 @@ void pagerankCalculateOrderedOmpU(vector<T>& e, vector<T>& r, const vector<T>& f
 template <class T>
 T pagerankErrorOmp(const vector<T>& x, const vector<T>& y, int i, int N, int EF) {
   switch (EF) {
-    case 1:  return l1NormOmp(x, y, i, N);
-    case 2:  return l2NormOmp(x, y, i, N);
-    default: return liNormOmp(x, y, i, N);
+    case 1:  return l1NormSimdOmp(x, y, i, N);
+    case 2:  return l2NormSimdOmp(x, y, i, N);
+    default: return liNormSimdOmp(x, y, i, N);
   }
 }
 
 template <class T>
 T pagerankErrorOmp(const vector<T>& x, int i, int N, int EF) {
   switch (EF) {
-    case 1:  return l1NormOmp(x, i, N);
-    case 2:  return l2NormOmp(x, i, N);
-    default: return liNormOmp(x, i, N);
+    case 1:  return l1NormSimdOmp(x, i, N);
+    case 2:  return l2NormSimdOmp(x, i, N);
+    default: return liNormSimdOmp(x, i, N);
   }
 }
 
@@ -105,23 +151,30 @@ T pagerankErrorOmp(const vector<T>& x, int i, int N, int EF) {
 // --------
 // For Monolithic / Componentwise PageRank.
 
-template <class H, class J, class M, class FL, class T=float>
-PagerankResult<T> pagerankOmp(const H& xt, const J& ks, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
-  int  N  = xt.order();
+template <class M, class FL, class T, class I>
+PagerankResult<T> pagerankOmp(PagerankCsr<T, I>& x, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
+  int  N  = x.order();
   T    p  = o.damping;
   T    E  = o.tolerance;
   int  L  = o.maxIterations, l = 0;
   int  EF = o.toleranceNorm;
-  auto vfrom = sourceOffsetsAs(xt, ks, int());
-  auto efrom = destinationIndicesAs(xt, ks, int());
-  auto vdata = vertexData(xt, ks);
-  vector<T> a(N), r(N), c(N), f(N), qc;
-  if (q) qc = compressContainer(xt, *q, ks);
+  bool PK = o.compress || o.precision;
+  if (q)  gatherValuesOmpW(x.q, *q, x.ks);
+  if (PK) pagerankPackOmpW(x.packed, x, o.compress, o.precision);
   float t = measureDuration([&]() {
-    if (q) copyValuesOmpW(r, qc);  // copy old ranks (qc), if given
-    else fillValueOmpU(r, T(1)/N);
-    pagerankFactorOmpW(f, vdata, 0, N, p); multiplyValuesOmpW(c, r, f, 0, N);  // calculate factors (f) and contributions (c)
-    l = fl(a, r, c, f, vfrom, efrom, vdata, i, ns, N, p, E, L, EF);            // calculate ranks of vertices
+    if (q) copyValuesOmpW(x.r, x.q);  // copy old ranks (q), if given
+    else fillValueOmpU(x.r, T(1)/N);
+    pagerankFactorOmpW(x.f, x.vdata, 0, N, p); multiplyValuesOmpW(x.c, x.r, x.f, 0, N);  // calculate factors (f) and contributions (c)
+    if (PK) pagerankPackedContributionsOmpW(x.packed, x.r, x.f);                   // calculate contributions in storage type
+    if (PK) l = fl(x.a, x.r, x.c, x.f, x.vfrom, x.packed, x.vdata, i, ns, N, p, E, L, EF);  // calculate ranks of vertices (compact storage)
+    else    l = fl(x.a, x.r, x.c, x.f, x.vfrom, x.efrom,  x.vdata, i, ns, N, p, E, L, EF);  // calculate ranks of vertices
   }, o.repeat);
-  return {decompressContainer(xt, r, ks), l, t};
+  vector<T> a(x.span());
+  scatterValuesOmpW(a, x.r, x.ks);
+  return {a, l, t};
+}
+
+template <class H, class J, class M, class FL, class T=float>
+PagerankResult<T> pagerankOmp(const H& xt, const J& ks, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
+  return pagerankCsrOmpDo<T>(xt, ks, [&](auto& x) { return pagerankOmp(x, i, ns, fl, q, o); });
 }
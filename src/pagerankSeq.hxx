@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <algorithm>
+#include <type_traits>
 #include "_main.hxx"
 #include "vertices.hxx"
 #include "edges.hxx"
@@ -9,6 +10,7 @@
 
 using std::vector;
 using std::swap;
+using std::integral_constant;
 
 
 
@@ -43,27 +45,117 @@ T pagerankTeleport(const vector<T>& r, const vector<int>& vdata, int N, T p) {
 
 
 
+// PAGERANK-PACKED
+// ---------------
+// For summing contributions over compact in-edges (C=1: coded), with
+// contributions in float (P=1), bf16 (P=2), or as rank * factor (P=0).
+
+template <int C, class FC, class I>
+inline double pagerankPackedSum(const PagerankPacked& x, const vector<I>& vfrom, int v, double a, FC fc) {
+  size_t n = vfrom[v+1] - vfrom[v];
+  if constexpr (C==1) {
+    if (n==0) return a;
+    const uint8_t *p = x.ebytes.data() + x.bfrom[v];
+    size_t z = readVarint(p);
+    int    u = v + int(int64_t(z >> 1) ^ -int64_t(z & 1));
+    a += fc(u);
+    for (size_t k=1; k<n; ++k) {
+      u += int(readVarint(p));
+      a += fc(u);
+    }
+  }
+  else {
+    const int *es = x.efrom + vfrom[v];
+    for (size_t k=0; k<n; ++k)
+      a += fc(es[k]);
+  }
+  return a;
+}
+
+
+// Update rank of vertex (v), and its contribution in storage type.
+template <int C, int P, class T, class I>
+inline void pagerankPackedRankU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, PagerankPacked& x, int v, T c0) {
+  auto fc = [&](int u) -> double {
+    if constexpr (P==1) return x.cf[u];
+    else if constexpr (P==2) return float(x.cb[u]);
+    else return double(f[u]) * r[u];
+  };
+  T a = T(pagerankPackedSum<C>(x, vfrom, v, c0, fc));
+  e[v] = a - r[v];
+  r[v] = a;
+  if constexpr (P==1) x.cf[v] = float(a*f[v]);
+  if constexpr (P==2) x.cb[v] = BFloat16(float(a*f[v]));
+}
+
+
+// Call fn(C, P) with storage mode of in-edges, contributions as constants.
+template <class F>
+inline void pagerankPackedDo(const PagerankPacked& x, F fn) {
+  using I0 = integral_constant<int, 0>;
+  using I1 = integral_constant<int, 1>;
+  using I2 = integral_constant<int, 2>;
+  switch (3*x.compress + x.precision) {
+    case 0:  fn(I0(), I0()); break;
+    case 1:  fn(I0(), I1()); break;
+    case 2:  fn(I0(), I2()); break;
+    case 3:  fn(I1(), I0()); break;
+    case 4:  fn(I1(), I1()); break;
+    default: fn(I1(), I2()); break;
+  }
+}
+
+
+
+
 // PAGERANK-CALCULATE
 // ------------------
 // For rank calculation from in-edges.
 
-template <class T>
-void pagerankCalculateW(vector<T>& a, const vector<T>& c, const vector<int>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
+template <class T, class I>
+void pagerankCalculateW(vector<T>& a, const vector<T>& c, const vector<I>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
   for (int v=i; v<i+n; v++)
-    a[v] = c0 + sumValuesAt(c, sliceIterable(efrom, vfrom[v], vfrom[v+1]));
+    a[v] = sumValuesAtSimd(c.data(), efrom.data()+vfrom[v], vfrom[v+1]-vfrom[v], c0);
 }
 
-template <class T>
-void pagerankCalculateOrderedU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<int>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
+template <class T, class I>
+void pagerankCalculateOrderedU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, const vector<int>& efrom, int i, int n, T c0) {
   for (int v=i; v<i+n; v++) {
-    T a = c0;
-    for (int u : sliceIterable(efrom, vfrom[v], vfrom[v+1]))
-      a += f[u] * r[u];
+    T a = sumProductsAtSimd(f.data(), r.data(), efrom.data()+vfrom[v], vfrom[v+1]-vfrom[v], c0);
     e[v] = a - r[v];
     r[v] = a;
   }
 }
 
+// Contributions (c) are always in rank type, only in-edges may be coded.
+template <class T, class I>
+void pagerankCalculateW(vector<T>& a, const vector<T>& c, const vector<I>& vfrom, const PagerankPacked& efrom, int i, int n, T c0) {
+  auto fc = [&](int u) -> double { return c[u]; };
+  pagerankPackedDo(efrom, [&](auto C, auto P) {
+    for (int v=i; v<i+n; v++)
+      a[v] = T(pagerankPackedSum<decltype(C)::value>(efrom, vfrom, v, c0, fc));
+  });
+}
+
+template <class T, class I>
+void pagerankCalculateOrderedU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, PagerankPacked& efrom, int i, int n, T c0) {
+  pagerankPackedDo(efrom, [&](auto C, auto P) {
+    for (int v=i; v<i+n; v++)
+      pagerankPackedRankU<decltype(C)::value, decltype(P)::value>(e, r, f, vfrom, efrom, v, c0);
+  });
+}
+
+// Ranks of listed vertices vs[i, i+n), with change in rank at list position.
+template <class T, class I>
+void pagerankCalculateOrderedAtU(vector<T>& e, vector<T>& r, const vector<T>& f, const vector<I>& vfrom, const vector<int>& efrom, const vector<int>& vs, int i, int n, T c0) {
+  for (int j=i; j<i+n; j++) {
+    int v = vs[j];
+    T a = sumProductsAtSimd(f.data(), r.data(), efrom.data()+vfrom[v], vfrom[v+1]-vfrom[v], c0);
+    e[j] = a - r[v];
+    r[v] = a;
+  }
+}
+
 
 
 
@@ -74,18 +166,18 @@ void pagerankCalculateOrderedU(vector<T>& e, vector<T>& r, const vector<T>& f, c
 template <class T>
 T pagerankError(const vector<T>& x, const vector<T>& y, int i, int N, int EF) {
   switch (EF) {
-    case 1:  return l1Norm(x, y, i, N);
-    case 2:  return l2Norm(x, y, i, N);
-    default: return liNorm(x, y, i, N);
+    case 1:  return l1NormSimd(x, y, i, N);
+    case 2:  return l2NormSimd(x, y, i, N);
+    default: return liNormSimd(x, y, i, N);
   }
 }
 
 template <class T>
 T pagerankError(const vector<T>& x, int i, int N, int EF) {
   switch (EF) {
-    case 1:  return l1Norm(x, i, N);
-    case 2:  return l2Norm(x, i, N);
-    default: return liNorm(x, i, N);
+    case 1:  return l1NormSimd(x, i, N);
+    case 2:  return l2NormSimd(x, i, N);
+    default: return liNormSimd(x, i, N);
   }
 }
 
@@ -96,23 +188,30 @@ T pagerankError(const vector<T>& x, int i, int N, int EF) {
 // --------
 // For Monolithic / Componentwise PageRank.
 
-template <class H, class J, class M, class FL, class T=float>
-PagerankResult<T> pagerankSeq(const H& xt, const J& ks, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
-  int  N  = xt.order();
+template <class M, class FL, class T, class I>
+PagerankResult<T> pagerankSeq(PagerankCsr<T, I>& x, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
+  int  N  = x.order();
   T    p  = o.damping;
   T    E  = o.tolerance;
   int  L  = o.maxIterations, l = 0;
   int  EF = o.toleranceNorm;
-  auto vfrom = sourceOffsetsAs(xt, ks, int());
-  auto efrom = destinationIndicesAs(xt, ks, int());
-  auto vdata = vertexData(xt, ks);
-  vector<T> a(N), r(N), c(N), f(N), qc;
-  if (q) qc = compressContainer(xt, *q, ks);
+  bool PK = o.compress || o.precision;
+  if (q)  gatherValuesW(x.q, *q, x.ks);
+  if (PK) pagerankPackOmpW(x.packed, x, o.compress, o.precision);
   float t = measureDuration([&]() {
-    if (q) copyValuesW(r, qc);   // copy old ranks (qc), if given
-    else fillValueU(r, T(1)/N);
-    pagerankFactorW(f, vdata, 0, N, p); multiplyValuesW(c, r, f, 0, N);  // calculate factors (f) and contributions (c)
-    l = fl(a, r, c, f, vfrom, efrom, vdata, i, ns, N, p, E, L, EF);      // calculate ranks of vertices
+    if (q) copyValuesW(x.r, x.q);  // copy old ranks (q), if given
+    else fillValueU(x.r, T(1)/N);
+    pagerankFactorW(x.f, x.vdata, 0, N, p); multiplyValuesW(x.c, x.r, x.f, 0, N);  // calculate factors (f) and contributions (c)
+    if (PK) pagerankPackedContributionsW(x.packed, x.r, x.f);                   // calculate contributions in storage type
+    if (PK) l = fl(x.a, x.r, x.c, x.f, x.vfrom, x.packed, x.vdata, i, ns, N, p, E, L, EF);  // calculate ranks of vertices (compact storage)
+    else    l = fl(x.a, x.r, x.c, x.f, x.vfrom, x.efrom,  x.vdata, i, ns, N, p, E, L, EF);  // calculate ranks of vertices
   }, o.repeat);
-  return {decompressContainer(xt, r, ks), l, t};
+  vector<T> a(x.span());
+  scatterValuesW(a, x.r, x.ks);
+  return {a, l, t};
+}
+
+template <class H, class J, class M, class FL, class T=float>
+PagerankResult<T> pagerankSeq(const H& xt, const J& ks, int i, const M& ns, FL fl, const vector<T> *q, const PagerankOptions<T>& o) {
+  return pagerankCsrDo<T>(xt, ks, [&](auto& x) { return pagerankSeq(x, i, ns, fl, q, o); });
 }
@@ -1,8 +1,11 @@
 #pragma once
 #include <random>
+#include <utility>
 #include <vector>
 
 using std::uniform_real_distribution;
+using std::pair;
+using std::vector;
 
 
 
@@ -74,3 +77,87 @@ bool removeRandomEdgeByDegree(G& a, R& rnd) {
   }
   return false;
 }
+
+
+
+
+// RANDOM-EDGE-BATCH
+// -----------------
+// Edges to insert (absent), delete (present, not self-loops) in a batch update.
+
+template <class G, class R>
+auto randomEdgeInsertions(const G& x, R& rnd, size_t n) {
+  using K = typename G::key_type;
+  uniform_real_distribution<> dis(0.0, 1.0);
+  vector<pair<K, K>> a;
+  for (size_t i=0; a.size()<n && i<8*n; ++i) {
+    K u = K(dis(rnd) * x.span());
+    K v = K(dis(rnd) * x.span());
+    if (!x.hasVertex(u) || !x.hasVertex(v) || x.hasEdge(u, v)) continue;
+    a.push_back({u, v});
+  }
+  return a;
+}
+
+
+template <class G, class R>
+auto randomEdgeDeletions(const G& x, R& rnd, size_t n) {
+  using K = typename G::key_type;
+  uniform_real_distribution<> dis(0.0, 1.0);
+  vector<pair<K, K>> a;
+  for (size_t i=0; a.size()<n && i<8*n; ++i) {
+    K u = K(dis(rnd) * x.span());
+    if (!x.hasVertex(u) || x.degree(u)==0) continue;
+    K vi = K(dis(rnd) * x.degree(u)), j = 0;
+    x.forEachEdgeKey(u, [&](auto v) {
+      if (j++ == vi && v != u) a.push_back({u, v});
+    });
+  }
+  return a;
+}
+
+
+
+
+// RANDOM-GRAPH
+// ------------
+// Synthetic graphs with vertices [1, n], for offline benchmarking.
+
+// Add (m) edges with uniformly random endpoints (Erdos-Renyi).
+template <class G, class R>
+void randomGraphW(G& a, R& rnd, size_t n, size_t m) {
+  using K = typename G::key_type;
+  uniform_real_distribution<> dis(0.0, 1.0);
+  for (size_t u=1; u<=n; ++u)
+    a.addVertex(K(u));
+  for (size_t i=0; i<m; ++i) {
+    K u = K(1 + dis(rnd) * n);
+    K v = K(1 + dis(rnd) * n);
+    a.addEdge(u, v);
+  }
+  a.correct();
+}
+
+
+// Add (m) edges by recursive quadrant choice (R-MAT), with 2^scale vertices.
+// This gives a skewed (power-law like) degree distribution.
+template <class G, class R>
+void rmatGraphW(G& a, R& rnd, int scale, size_t m, double pa=0.57, double pb=0.19, double pc=0.19) {
+  using K = typename G::key_type;
+  uniform_real_distribution<> dis(0.0, 1.0);
+  size_t n = size_t(1) << scale;
+  for (size_t u=1; u<=n; ++u)
+    a.addVertex(K(u));
+  for (size_t i=0; i<m; ++i) {
+    size_t u = 0, v = 0;
+    for (int b=0; b<scale; ++b) {
+      double r = dis(rnd);
+      if      (r < pa)       {}
+      else if (r < pa+pb)    v |= size_t(1) << b;
+      else if (r < pa+pb+pc) u |= size_t(1) << b;
+      else { u |= size_t(1) << b; v |= size_t(1) << b; }
+    }
+    a.addEdge(K(1 + u), K(1 + v));
+  }
+  a.correct();
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include "_main.hxx"
+#include "vertices.hxx"
+#include "components.hxx"
+#include "sort.hxx"
+
+using std::pair;
+using std::vector;
+using std::stable_sort;
+using std::reverse;
+using std::make_pair;
+
+
+
+
+// COMPONENTS-ORDER
+// ----------------
+// Arrange vertices by strongly connected components, in topological order
+// (vertices, start offset of each component).
+
+template <class G, class H>
+auto componentsOrder(const G& x, const H& xt) {
+  using K = typename G::key_type;
+  auto cs = topologicalComponents(x, xt);
+  vector<K> a; vector<K> cfrom;
+  for (const auto& c : cs) {
+    cfrom.push_back(K(a.size()));
+    copyAppend(c, a);
+  }
+  cfrom.push_back(K(a.size()));
+  return make_pair(a, cfrom);
+}
+
+
+
+
+// REVERSE-CUTHILL-MCKEE-ORDER
+// ---------------------------
+// Arrange vertices by breadth-first search (on both in- and out-edges), from
+// lowest degree vertices, visiting neighbours by ascending degree, reversed.
+// This reduces the bandwidth of the adjacency matrix.
+
+template <class G, class H>
+auto reverseCuthillMckeeOrder(const G& x, const H& xt) {
+  using K = typename G::key_type;
+  auto deg = createContainer(x, K());
+  auto vis = createContainer(x, bool());
+  vector<K> a, vs, ns;
+  x.forEachVertexKey([&](auto u) {
+    deg[u] = x.degree(u) + xt.degree(u);
+    vs.push_back(u);
+  });
+  auto fd = [&](K u, K v) { return deg[u] < deg[v]; };
+  stable_sort(vs.begin(), vs.end(), fd);
+  a.reserve(vs.size());
+  for (K s : vs) {
+    if (vis[s]) continue;
+    size_t i = a.size();
+    vis[s] = true; a.push_back(s);
+    for (; i<a.size(); ++i) {
+      K u = a[i]; ns.clear();
+      auto fn = [&](auto v) { if (!vis[v]) { vis[v] = true; ns.push_back(v); } };
+      x.forEachEdgeKey(u, fn);
+      xt.forEachEdgeKey(u, fn);
+      stable_sort(ns.begin(), ns.end(), fd);
+      copyAppend(ns, a);
+    }
+  }
+  reverse(a.begin(), a.end());
+  return a;
+}
+
+
+
+
+// IN-DEGREE-ORDER
+// ---------------
+// Arrange vertices in buckets of in-degree (by powers of 2), highest first.
+// Vertices keep their relative order within a bucket.
+
+template <class H>
+auto inDegreeOrder(const H& xt) {
+  using K = typename H::key_type;
+  vector2d<K> bs;
+  xt.forEachVertexKey([&](auto u) {
+    size_t b = 0;
+    for (size_t d=xt.degree(u); d>1; d>>=1) ++b;
+    if (b>=bs.size()) bs.resize(b+1);
+    bs[b].push_back(u);
+  });
+  vector<K> a;
+  for (size_t b=bs.size(); b>0; --b)
+    copyAppend(bs[b-1], a);
+  return a;
+}